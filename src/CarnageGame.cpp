@@ -4,9 +4,14 @@
 #include "SpriteManager.h"
 #include "ConsoleWindow.h"
 #include "GameCheatsWindow.h"
+#include "RenderStatsWindow.h"
+#include "PhysicsStatsWindow.h"
 #include "PhysicsManager.h"
 #include "Pedestrian.h"
+#include "Vehicle.h"
 #include "MemoryManager.h"
+#include "WorldSnapshot.h"
+#include "WorldStateHash.h"
 
 static const char* InputsConfigPath = "config/inputs.json";
 static const char* GTA1MapFileExtension = ".CMP";
@@ -125,6 +130,16 @@ bool CarnageGame::Initialize()
         SetupHumanCharacter(icurr, pedestrian);
     }
 
+    if (gSystem.mStartupParams.mBenchmarkCars > 0)
+    {
+        SpawnBenchmarkCars(gSystem.mStartupParams.mBenchmarkCars, pos[0]);
+    }
+
+    if (gSystem.mStartupParams.mBenchmarkPedestrians > 0)
+    {
+        SpawnBenchmarkPedestrians(gSystem.mStartupParams.mBenchmarkPedestrians, pos[0]);
+    }
+
     SetupScreenLayout(mNumPlayers);
     mGameTime = 0;
     return true;
@@ -154,6 +169,9 @@ void CarnageGame::UpdateFrame(Timespan deltaTime)
         mHumanSlot[ihuman].mCharController.UpdateFrame(mHumanSlot[ihuman].mCharPedestrian, deltaTime);
         mHumanSlot[ihuman].mCharView.UpdateFrame(deltaTime);
     }
+
+    gGameObjectsManager.CollectDrawData();
+    gWorldStateHashLog.ProcessTick();
 }
 
 void CarnageGame::InputEvent(KeyInputEvent& inputEvent)
@@ -184,6 +202,18 @@ void CarnageGame::InputEvent(KeyInputEvent& inputEvent)
         return;
     }
 
+    if (inputEvent.mKeycode == eKeycode_F4 && inputEvent.mPressed)
+    {
+        gRenderStatsWindow.mWindowShown = !gRenderStatsWindow.mWindowShown;
+        return;
+    }
+
+    if (inputEvent.mKeycode == eKeycode_F5 && inputEvent.mPressed)
+    {
+        gPhysicsStatsWindow.mWindowShown = !gPhysicsStatsWindow.mWindowShown;
+        return;
+    }
+
     for (int ihuman = 0; ihuman < GAME_MAX_PLAYERS; ++ihuman)
     {
         if (mHumanSlot[ihuman].mCharPedestrian == nullptr)
@@ -320,6 +350,120 @@ void CarnageGame::SetupHumanCharacter(int humanIndex, Pedestrian* pedestrian)
     mHumanSlot[humanIndex].mCharView.mHUD.Setup(pedestrian);
 }
 
+void CarnageGame::SpawnBenchmarkCars(int carsCount, const glm::vec3& position)
+{
+    std::vector<CarStyle*> carStyles;
+    for (CarStyle& currStyle: gGameMap.mStyleData.mCars)
+    {
+        if (currStyle.mVType == eCarVType_Boat || currStyle.mVType == eCarVType_Train || currStyle.mVType == eCarVType_Tram)
+            continue;
+
+        carStyles.push_back(&currStyle);
+    }
+
+    if (carStyles.empty())
+        return;
+
+    // cars are rotated randomly, so keep them apart by longest chassis diagonal to avoid overlaps on spawn
+    float maxCarLength = 0.0f;
+    for (CarStyle* currStyle: carStyles)
+    {
+        glm::vec2 chassisSize { ConvertPixelsToMap(currStyle->mWidth), ConvertPixelsToMap(currStyle->mHeight) };
+        maxCarLength = glm::max(maxCarLength, glm::length(chassisSize));
+    }
+    int blocksStep = glm::max(static_cast<int>(ceilf(maxCarLength / MAP_BLOCK_LENGTH)), 1);
+
+    // keep whole cars within physics activity zone so all of them are simulated
+    std::vector<glm::vec3> spawnPositions;
+    CollectSpawnPositions(position, blocksStep, PHYSICS_ACTIVITY_ZONE_RADIUS - maxCarLength * 0.5f, carsCount, spawnPositions);
+
+    int numSpawned = 0;
+    for (const glm::vec3& carPosition: spawnPositions)
+    {
+        CarStyle* carStyle = carStyles[mGameRand.generate_int(static_cast<int>(carStyles.size()))];
+        float randomAngle = 360.0f * mGameRand.generate_float();
+
+        Vehicle* car = gGameObjectsManager.CreateCar(carPosition, cxx::angle_t::from_degrees(randomAngle), carStyle);
+        if (car == nullptr)
+            continue;
+
+        // push car forward so there are moving bodies and contacts
+        car->mPhysicsComponent->SetLinearVelocity(car->mPhysicsComponent->GetSignVector() * MAP_BLOCK_LENGTH * 2.0f);
+        ++numSpawned;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Spawned %d benchmark cars of %d requested", numSpawned, carsCount);
+}
+
+void CarnageGame::CollectSpawnPositions(const glm::vec3& position, int blocksStep, float maxDistance, int maxCount, std::vector<glm::vec3>& outPositions) const
+{
+    debug_assert(blocksStep > 0);
+
+    const int MaxRingIndex = glm::min(static_cast<int>(maxDistance / (blocksStep * MAP_BLOCK_LENGTH)), MAP_DIMENSIONS / blocksStep);
+    const int centerx = static_cast<int>(position.x);
+    const int centerz = static_cast<int>(position.z);
+
+    int numPositions = 0;
+    for (int iring = 1; iring <= MaxRingIndex && numPositions < maxCount; ++iring)
+    {
+        for (int offsetz = -iring; offsetz <= iring && numPositions < maxCount; ++offsetz)
+        for (int offsetx = -iring; offsetx <= iring && numPositions < maxCount; ++offsetx)
+        {
+            if (abs(offsetx) != iring && abs(offsetz) != iring)
+                continue;
+
+            int xBlock = centerx + offsetx * blocksStep;
+            int zBlock = centerz + offsetz * blocksStep;
+            if (xBlock < 0 || zBlock < 0 || xBlock >= MAP_DIMENSIONS || zBlock >= MAP_DIMENSIONS)
+                continue;
+
+            glm::vec3 spawnPosition (xBlock + MAP_BLOCK_LENGTH * 0.5f, MAP_LAYERS_COUNT - 1, zBlock + MAP_BLOCK_LENGTH * 0.5f);
+            // ring corners are farther than ring index suggests
+            if (glm::length(glm::vec2(spawnPosition.x - position.x, spawnPosition.z - position.z)) > maxDistance)
+                continue;
+
+            spawnPosition.y = gGameMap.GetHeightAtPosition(spawnPosition);
+
+            int yBlock = static_cast<int>(spawnPosition.y);
+            if (yBlock > MAP_LAYERS_COUNT - 1)
+                continue;
+
+            BlockStyle* currBlock = gGameMap.GetBlock(xBlock, zBlock, yBlock);
+            if (currBlock->mGroundType != eGroundType_Field &&
+                currBlock->mGroundType != eGroundType_Pawement &&
+                currBlock->mGroundType != eGroundType_Road)
+            {
+                continue;
+            }
+
+            outPositions.push_back(spawnPosition);
+            ++numPositions;
+        }
+    }
+}
+
+void CarnageGame::SpawnBenchmarkPedestrians(int pedestriansCount, const glm::vec3& position)
+{
+    // one pedestrian per block on rings around center, most of pedestrians end up far from player
+    std::vector<glm::vec3> spawnPositions;
+    CollectSpawnPositions(position, 1, MAP_DIMENSIONS * MAP_BLOCK_LENGTH, pedestriansCount, spawnPositions);
+
+    int numSpawned = 0;
+    for (const glm::vec3& pedPosition: spawnPositions)
+    {
+        float randomAngle = 360.0f * mGameRand.generate_float();
+
+        Pedestrian* pedestrian = gGameObjectsManager.CreatePedestrian(pedPosition, cxx::angle_t::from_degrees(randomAngle));
+        if (pedestrian == nullptr)
+            continue;
+
+        pedestrian->mCtlActions[ePedestrianAction_WalkForward] = true;
+        ++numSpawned;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Spawned %d benchmark pedestrians of %d requested", numSpawned, pedestriansCount);
+}
+
 void CarnageGame::SetupScreenLayout(int playersCount)
 {   
     // todo: what a mess
@@ -360,3 +504,67 @@ int CarnageGame::GetPlayerIndex(const HumanCharacterController* controller) cons
     }
     return -1;
 }
+
+void CarnageGame::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    snapshot.Write(mGameTime);
+
+    std::string randomState;
+    mGameRand.get_state(randomState);
+    snapshot.WriteString(randomState);
+
+    gPhysics.SaveSnapshot(snapshot);
+    gGameObjectsManager.SaveSnapshot(snapshot);
+
+    for (int icurr = 0; icurr < mNumPlayers; ++icurr)
+    {
+        const HumanCharacterSlot& currentSlot = mHumanSlot[icurr];
+        GameObjectID objectID = currentSlot.mCharPedestrian ? currentSlot.mCharPedestrian->mObjectID : GAMEOBJECT_ID_NULL;
+        snapshot.Write(objectID);
+        currentSlot.mCharController.SaveSnapshot(snapshot);
+    }
+}
+
+bool CarnageGame::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    Timespan gameTime;
+    std::string randomState;
+    if (!snapshot.Read(gameTime) || !snapshot.ReadString(randomState))
+        return false;
+
+    // unbind human characters before its pedestrians gets destroyed
+    for (int icurr = 0; icurr < mNumPlayers; ++icurr)
+    {
+        mHumanSlot[icurr].mCharController.SetCharacter(nullptr);
+        mHumanSlot[icurr].mCharPedestrian = nullptr;
+    }
+
+    gGameObjectsManager.DestroyAllObjects();
+
+    if (!gPhysics.LoadSnapshot(snapshot) || !gGameObjectsManager.LoadSnapshot(snapshot))
+        return false;
+
+    for (int icurr = 0; icurr < mNumPlayers; ++icurr)
+    {
+        HumanCharacterSlot& currentSlot = mHumanSlot[icurr];
+
+        GameObjectID objectID = GAMEOBJECT_ID_NULL;
+        if (!snapshot.Read(objectID) || !currentSlot.mCharController.LoadSnapshot(snapshot))
+            return false;
+
+        Pedestrian* pedestrian = gGameObjectsManager.GetPedestrianByID(objectID);
+        if (pedestrian == nullptr)
+        {
+            debug_assert(false);
+            return false;
+        }
+        currentSlot.mCharPedestrian = pedestrian;
+        currentSlot.mCharController.SetCharacter(pedestrian);
+        currentSlot.mCharView.mFollowCameraController.SetFollowTarget(pedestrian);
+        currentSlot.mCharView.mHUD.Setup(pedestrian);
+    }
+
+    mGameTime = gameTime;
+    mGameRand.set_state(randomState);
+    return true;
+}
@@ -48,10 +48,35 @@ public:
     void SetupHumanCharacter(int playerIndex, Pedestrian* pedestrian);
     void SetupScreenLayout(int playersCount);
 
+    // spawn cars on free ground blocks around position, used for physics benchmarking
+    // @param carsCount: Number of cars to spawn
+    // @param position: Spawn area center
+    void SpawnBenchmarkCars(int carsCount, const glm::vec3& position);
+
+    // spawn walking pedestrians on free ground blocks around position, used for physics benchmarking
+    // @param pedestriansCount: Number of pedestrians to spawn
+    // @param position: Spawn area center
+    void SpawnBenchmarkPedestrians(int pedestriansCount, const glm::vec3& position);
+
+    // collect centers of ground blocks on square rings around position, nearest rings first
+    // @param position: Rings center, center block itself is skipped
+    // @param blocksStep: Distance between neighbouring spawn positions, in blocks
+    // @param maxDistance: Max distance from rings center to spawn position
+    // @param maxCount: Max number of spawn positions
+    // @param outPositions: Output positions on ground level
+    void CollectSpawnPositions(const glm::vec3& position, int blocksStep, float maxDistance, int maxCount, std::vector<glm::vec3>& outPositions) const;
+
     // get player index from human char controller
     // @returns -1 on error
     int GetPlayerIndex(const HumanCharacterController* controller) const;
 
+    // write or read whole gamestate, see WorldSnapshot
+    // on load all existing gameobjects get destroyed and recreated from snapshot data,
+    // snapshot must be validated before load, see WorldSnapshot::Restore
+    // @param snapshot: Snapshot data
+    void SaveSnapshot(WorldSnapshot& snapshot) const;
+    bool LoadSnapshot(WorldSnapshot& snapshot);
+
 private:
     bool SetInputActionsFromConfig();
 };
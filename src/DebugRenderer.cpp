@@ -4,6 +4,8 @@
 #include "RenderView.h"
 #include "GpuBuffer.h"
 
+const unsigned int InitialVerticesCount = 4096;
+
 static struct DebugSpherePrecomp
 {
     DebugSpherePrecomp()
@@ -53,15 +55,11 @@ DebugRenderer::DebugRenderer()
 
 bool DebugRenderer::Initialize()
 {
-    mVerticesBuffer = gGraphicsDevice.CreateBuffer(eBufferContent_Vertices, eBufferUsage_Stream, mMaxVerticesCount * Sizeof_Vertex3D_Debug, nullptr);
+    mVerticesBuffer = gGraphicsDevice.CreateBuffer(eBufferContent_Vertices, eBufferUsage_Stream, InitialVerticesCount * Sizeof_Vertex3D_Debug, nullptr);
     debug_assert(mVerticesBuffer);
 
-    mVerticesPointer = static_cast<Vertex3D_Debug*>(mVerticesBuffer->Lock(BufferAccess_UnsynchronizedWrite));
-    debug_assert(mVerticesPointer);
-
-    mCurrVerticesCount = 0;
-
-    return true;
+    mLineVertices.reserve(InitialVerticesCount);
+    return mVerticesBuffer != nullptr;
 }
 
 void DebugRenderer::Deinit()
@@ -70,8 +68,8 @@ void DebugRenderer::Deinit()
     {
         gGraphicsDevice.DestroyBuffer(mVerticesBuffer);
         mVerticesBuffer = nullptr;
-        mVerticesPointer = nullptr;
     }
+    mLineVertices.clear();
 }
 
 void DebugRenderer::RenderFrameBegin(RenderView* renderview)
@@ -93,40 +91,54 @@ void DebugRenderer::RenderFrameEnd()
 }
 
 void DebugRenderer::FlushPrimitives()
-{
-    if (mCurrVerticesCount == 0)
-        return;
-
-    if (!mVerticesBuffer->Unlock())
-    {
-        debug_assert(false);
-    }
-
-    Vertex3D_Debug_Format vFormat;
-    gGraphicsDevice.BindVertexBuffer(mVerticesBuffer, vFormat);
-    gGraphicsDevice.RenderPrimitives(ePrimitiveType_Lines, 0, mCurrVerticesCount);
+{
+    if (mLineVertices.empty() || mVerticesBuffer == nullptr)
+    {
+        mLineVertices.clear();
+        return;
+    }
 
-    mVerticesBuffer->Invalidate();
+    unsigned int verticesDataLength = mLineVertices.size() * Sizeof_Vertex3D_Debug;
+    if (verticesDataLength > mVerticesBuffer->mBufferCapacity)
+    {
+        // grow twice at least to avoid reallocations on next frames
+        unsigned int newBufferLength = std::max(verticesDataLength, mVerticesBuffer->mBufferCapacity * 2);
+        if (!mVerticesBuffer->Setup(eBufferUsage_Stream, newBufferLength, nullptr))
+        {
+            debug_assert(false);
+            mLineVertices.clear();
+            return;
+        }
+    }
+    else
+    {
+        mVerticesBuffer->Invalidate();
+    }
+
+    if (!mVerticesBuffer->SubData(0, verticesDataLength, mLineVertices.data()))
+    {
+        debug_assert(false);
+        mLineVertices.clear();
+        return;
+    }
 
-    mVerticesPointer = static_cast<Vertex3D_Debug*>(mVerticesBuffer->Lock(BufferAccess_UnsynchronizedWrite));
-    debug_assert(mVerticesPointer);
+    // single draw for all lines
+    Vertex3D_Debug_Format vFormat;
+    gGraphicsDevice.BindVertexBuffer(mVerticesBuffer, vFormat);
+    gGraphicsDevice.RenderPrimitives(ePrimitiveType_Lines, 0, mLineVertices.size());
 
-    mCurrVerticesCount = 0;
+    mLineVertices.clear();
 }
-
+
 void DebugRenderer::DrawLine(const glm::vec3& point_a, const glm::vec3& point_b, unsigned int line_color)
 {
-    if ((mCurrVerticesCount + 2) >= mMaxVerticesCount)
-    {
-        FlushPrimitives();
-    }
-
-    mVerticesPointer[mCurrVerticesCount + 0].mPosition = point_a;
-    mVerticesPointer[mCurrVerticesCount + 0].mColor = line_color;
+    mLineVertices.emplace_back();
+    mLineVertices.back().mPosition = point_a;
+    mLineVertices.back().mColor = line_color;
 
-    mVerticesPointer[mCurrVerticesCount + 1].mPosition = point_b;
-    mVerticesPointer[mCurrVerticesCount + 1].mColor = line_color;
-    mCurrVerticesCount += 2;
+    mLineVertices.emplace_back();
+    mLineVertices.back().mPosition = point_b;
+    mLineVertices.back().mColor = line_color;
 }
 
 void DebugRenderer::DrawCube(const glm::vec3& point_center, const glm::vec3& cube_dimensions, unsigned int line_color)
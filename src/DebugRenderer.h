@@ -25,10 +25,10 @@ private:
 
 private:
     GpuBuffer* mVerticesBuffer = nullptr;
-    Vertex3D_Debug* mVerticesPointer = nullptr;
 
-    const unsigned int mMaxVerticesCount = 4096;
-    unsigned int mCurrVerticesCount = 0;
+    // all debug shapes are made of lines, they are collected during frame and submitted at once
+    // memory is kept between frames so it grows to fit most crowded scene
+    std::vector<Vertex3D_Debug> mLineVertices;
 
     RenderView* mCurrentRenderView = nullptr;
 };
\ No newline at end of file
@@ -24,9 +24,9 @@ void FollowCameraController::Setup(GameCamera* gameCamera)
     mCamera->SetIdentity();
     mCamera->SetPerspectiveProjection(screenAspect, 55.0f, 0.1f, 1000.0f);
     
-    if (mFollowPedestrian)
+    if (Pedestrian* followPedestrian = gGameObjectsManager.GetPedestrianByHandle(mFollowPedestrian))
     {
-        glm::vec3 position = mFollowPedestrian->mPhysicsComponent->GetPosition();
+        glm::vec3 position = followPedestrian->mPhysicsComponent->GetPosition();
         mCamera->SetPosition({position.x, position.y + mStartupCameraHeight, position.z}); 
     }
     else
@@ -38,17 +38,18 @@ void FollowCameraController::Setup(GameCamera* gameCamera)
 
 void FollowCameraController::UpdateFrame(Timespan deltaTime)
 {
-    if (mFollowPedestrian == nullptr)
+    Pedestrian* followPedestrian = gGameObjectsManager.GetPedestrianByHandle(mFollowPedestrian);
+    if (followPedestrian == nullptr)
         return;
 
-    glm::vec3 position = mFollowPedestrian->mPhysicsComponent->GetPosition();
+    glm::vec3 position = followPedestrian->mPhysicsComponent->GetPosition();
     position.y = position.y + (mFollowPedCameraHeight + mScrollHeightOffset);
 
     float catchSpeed = mFollowPedCameraCatchSpeed;
     // todo: temporary implementation
-    if (mFollowPedestrian->IsCarPassenger())
+    if (followPedestrian->IsCarPassenger())
     {
-        glm::vec2 carVelocity = mFollowPedestrian->mCurrentCar->mPhysicsComponent->GetLinearVelocity();
+        glm::vec2 carVelocity = followPedestrian->mCurrentCar->mPhysicsComponent->GetLinearVelocity();
         float carSpeed = glm::length(carVelocity);
         carVelocity = glm::normalize(carVelocity);
         position.x += (carVelocity.x * carSpeed * 0.35f);
@@ -81,5 +82,5 @@ void FollowCameraController::InputEvent(MouseScrollInputEvent& inputEvent)
 
 void FollowCameraController::SetFollowTarget(Pedestrian* pedestrian)
 {
-    mFollowPedestrian = pedestrian;
+    mFollowPedestrian = pedestrian ? pedestrian->GetHandle() : GameObjectHandle();
 }
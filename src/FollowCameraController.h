@@ -30,5 +30,5 @@ private:
     float mScrollHeightOffset;
     float mFollowPedCameraCatchSpeed;
 
-    Pedestrian* mFollowPedestrian = nullptr;
+    GameObjectHandle mFollowPedestrian;
 };
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "stdafx.h"
+#include "FrameCapture.h"
+#include "CarnageGame.h"
+#include "GraphicsDevice.h"
+
+FrameCapture gFrameCapture;
+
+bool FrameCapture::Initialize(const char* scriptFileName)
+{
+    Deinit();
+
+    std::string jsonContent;
+    if (!gFiles.ReadTextFile(scriptFileName, jsonContent))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot load frame capture script '%s'", scriptFileName);
+        return false;
+    }
+
+    cxx::config_document configDocument;
+    if (!configDocument.parse_document(jsonContent.c_str()))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot parse frame capture script '%s'", scriptFileName);
+        return false;
+    }
+
+    cxx::config_node rootNode = configDocument.get_root_node();
+    if (cxx::config_node warmupFrames = rootNode.get_child("warmup_frames"))
+    {
+        mWarmupFrames = std::max(warmupFrames.get_value_integer(), 0);
+    }
+    if (cxx::config_node measureFrames = rootNode.get_child("measure_frames"))
+    {
+        mMeasureFrames = std::max(measureFrames.get_value_integer(), 1);
+    }
+    if (cxx::config_node pixelTolerance = rootNode.get_child("pixel_tolerance"))
+    {
+        mPixelTolerance = pixelTolerance.get_value_integer();
+    }
+    if (cxx::config_node frameDelta = rootNode.get_child("frame_delta_ms"))
+    {
+        mFrameDelta = std::max(frameDelta.get_value_integer(), 1);
+    }
+
+    mOutputDirectory = gFiles.mWorkingDirectoryPath + "/captures";
+    if (cxx::config_node outputDirectory = rootNode.get_child("output_directory"))
+    {
+        mOutputDirectory = outputDirectory.get_value_string();
+    }
+
+    cxx::config_node shotsNode = rootNode.get_child("shots");
+    for (int ishot = 0, NumShots = shotsNode.get_array_elements_count(); ishot < NumShots; ++ishot)
+    {
+        cxx::config_node currShotNode = shotsNode.get_array_element(ishot);
+        cxx::config_node positionNode = currShotNode.get_child("position");
+        if (positionNode.get_array_elements_count() != 3)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Frame capture shot %d has invalid camera position", ishot);
+            continue;
+        }
+
+        CaptureShot& captureShot = mShots.emplace_back();
+        if (cxx::config_node nameNode = currShotNode.get_child("name"))
+        {
+            captureShot.mName = nameNode.get_value_string();
+        }
+        if (captureShot.mName.empty())
+        {
+            captureShot.mName = "shot_" + std::to_string(ishot);
+        }
+        captureShot.mCameraPosition.x = positionNode.get_array_element(0).get_value_float();
+        captureShot.mCameraPosition.y = positionNode.get_array_element(1).get_value_float();
+        captureShot.mCameraPosition.z = positionNode.get_array_element(2).get_value_float();
+    }
+
+    if (mShots.empty())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Frame capture script '%s' has no shots", scriptFileName);
+        return false;
+    }
+
+    if (!cxx::ensure_path_exists(mOutputDirectory))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot create frame capture directory '%s'", mOutputDirectory.c_str());
+        mShots.clear();
+        return false;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Frame capture started: %d shots, output to '%s'", (int) mShots.size(), mOutputDirectory.c_str());
+    return true;
+}
+
+void FrameCapture::Deinit()
+{
+    mShots.clear();
+    mFramePixels.Cleanup();
+    mCurrentShot = 0;
+    mShotFrame = 0;
+}
+
+void FrameCapture::UpdateFrame()
+{
+    if (!IsCaptureActive())
+        return;
+
+    // override follow camera of first human view
+    GameCamera& camera = gCarnageGame.mHumanSlot[0].mCharView.mCamera;
+    camera.SetPosition(mShots[mCurrentShot].mCameraPosition);
+    camera.SetTopDownOrientation();
+}
+
+void FrameCapture::ProcessFrame()
+{
+    if (!IsCaptureActive())
+        return;
+
+    if (mShotFrame >= mWarmupFrames)
+    {
+        CaptureShot& captureShot = mShots[mCurrentShot];
+        for (int istage = 0; istage < eRenderStage_COUNT; ++istage)
+        {
+            captureShot.mRenderStageTimeMs[istage] += gRenderManager.mRenderStageTimeMs[istage];
+            captureShot.mFrameTimeMs += gRenderManager.mRenderStageTimeMs[istage];
+        }
+        captureShot.mDrawCalls = gGraphicsDevice.mFrameStats.mDrawCalls;
+    }
+
+    if (++mShotFrame < mWarmupFrames + mMeasureFrames)
+        return;
+
+    FinishShot();
+
+    mShotFrame = 0;
+    if (++mCurrentShot == static_cast<int>(mShots.size()))
+    {
+        FinishCapture();
+    }
+}
+
+void FrameCapture::ReadFramePixels()
+{
+    double readbackStartTime = gSystem.GetSysSeconds();
+    if (!gGraphicsDevice.ReadFramebufferPixels(mFramePixels))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot read frame pixels");
+    }
+    mShots[mCurrentShot].mReadbackTimeMs = (gSystem.GetSysSeconds() - readbackStartTime) * 1000.0;
+}
+
+bool FrameCapture::IsCaptureActive() const
+{
+    return mCurrentShot < static_cast<int>(mShots.size());
+}
+
+bool FrameCapture::IsFramePixelsRequested() const
+{
+    // last measured frame of shot
+    return IsCaptureActive() && (mShotFrame == mWarmupFrames + mMeasureFrames - 1);
+}
+
+void FrameCapture::FinishShot()
+{
+    CaptureShot& captureShot = mShots[mCurrentShot];
+    for (double& stageTime: captureShot.mRenderStageTimeMs)
+    {
+        stageTime /= mMeasureFrames;
+    }
+    captureShot.mFrameTimeMs /= mMeasureFrames;
+
+    std::string frameFilePath = mOutputDirectory + "/" + captureShot.mName + ".png";
+    if (!mFramePixels.HasContent() || !mFramePixels.SaveToFile(frameFilePath.c_str()))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot save captured frame '%s'", frameFilePath.c_str());
+    }
+
+    std::string goldenFilePath = mOutputDirectory + "/golden/" + captureShot.mName + ".png";
+    captureShot.mMismatchedPixels = CompareWithGoldenFrame(goldenFilePath);
+
+    cxx::string_buffer_256 stagesString;
+    for (int istage = 0; istage < eRenderStage_COUNT; ++istage)
+    {
+        stagesString.append_string(" ");
+        stagesString.append_string(cxx::enum_to_string(static_cast<eRenderStage>(istage)));
+        cxx::string_buffer_16 stageTimeString;
+        stageTimeString.printf(" %.3f", captureShot.mRenderStageTimeMs[istage]);
+        stagesString.append_string(stageTimeString.c_str());
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Frame capture '%s': frame %.3f ms, readback %.3f ms, draw calls %d, golden %s; stages ms:%s",
+        captureShot.mName.c_str(), 
+        captureShot.mFrameTimeMs, 
+        captureShot.mReadbackTimeMs,
+        captureShot.mDrawCalls,
+        (captureShot.mMismatchedPixels < 0) ? "missing" : (captureShot.mMismatchedPixels == 0) ? "match" : "MISMATCH",
+        stagesString.c_str());
+}
+
+void FrameCapture::FinishCapture()
+{
+    // write timings table
+    std::string timingsFilePath = mOutputDirectory + "/timings.csv";
+    std::ofstream outputStream {timingsFilePath, std::ios::out | std::ios::trunc};
+    if (outputStream.is_open())
+    {
+        outputStream << "shot,frame_ms";
+        for (int istage = 0; istage < eRenderStage_COUNT; ++istage)
+        {
+            outputStream << "," << cxx::enum_to_string(static_cast<eRenderStage>(istage)) << "_ms";
+        }
+        outputStream << ",readback_ms,draw_calls,mismatched_pixels\n";
+
+        for (const CaptureShot& currShot: mShots)
+        {
+            outputStream << currShot.mName << "," << currShot.mFrameTimeMs;
+            for (double stageTime: currShot.mRenderStageTimeMs)
+            {
+                outputStream << "," << stageTime;
+            }
+            outputStream << "," << currShot.mReadbackTimeMs << "," << currShot.mDrawCalls << "," << currShot.mMismatchedPixels << "\n";
+        }
+    }
+    else
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot write frame capture timings '%s'", timingsFilePath.c_str());
+    }
+
+    int mismatchesCount = 0;
+    for (const CaptureShot& currShot: mShots)
+    {
+        if (currShot.mMismatchedPixels > 0)
+        {
+            ++mismatchesCount;
+        }
+    }
+    gConsole.LogMessage(eLogMessage_Info, "Frame capture finished: %d shots, %d mismatched golden frames", (int) mShots.size(), mismatchesCount);
+    gSystem.QuitRequest();
+}
+
+int FrameCapture::CompareWithGoldenFrame(const std::string& goldenFilePath) const
+{
+    if (!mFramePixels.HasContent() || !cxx::is_file_exists(goldenFilePath))
+        return -1;
+
+    PixelsArray goldenPixels;
+    if (!goldenPixels.LoadFromFile(goldenFilePath.c_str(), eTextureFormat_RGBA8))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot load golden frame '%s'", goldenFilePath.c_str());
+        return -1;
+    }
+
+    // different resolution, all pixels are counted as mismatched
+    if (goldenPixels.mSizex != mFramePixels.mSizex || goldenPixels.mSizey != mFramePixels.mSizey)
+        return mFramePixels.mSizex * mFramePixels.mSizey;
+
+    int mismatchedPixels = 0;
+    for (int ipixel = 0, NumPixels = mFramePixels.mSizex * mFramePixels.mSizey; ipixel < NumPixels; ++ipixel)
+    {
+        const unsigned char* pixelA = mFramePixels.mData + ipixel * 4;
+        const unsigned char* pixelB = goldenPixels.mData + ipixel * 4;
+        // ignore alpha channel
+        for (int icomponent = 0; icomponent < 3; ++icomponent)
+        {
+            if (std::abs(pixelA[icomponent] - pixelB[icomponent]) > mPixelTolerance)
+            {
+                ++mismatchedPixels;
+                break;
+            }
+        }
+    }
+    return mismatchedPixels;
+}
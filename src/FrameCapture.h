@@ -0,0 +1,62 @@
+#pragma once
+
+#include "RenderingManager.h"
+
+// runs scripted camera shots, writes rendered frames to png files and measures cpu time of render stages,
+// intended for automated render performance and correctness tests, usually together with offscreen mode
+class FrameCapture final: public cxx::noncopyable
+{
+public:
+    // single camera shot of capture script
+    struct CaptureShot
+    {
+    public:
+        std::string mName;
+        glm::vec3 mCameraPosition;
+        // measured results
+        double mRenderStageTimeMs[eRenderStage_COUNT] = {}; // average
+        double mFrameTimeMs = 0.0; // average
+        double mReadbackTimeMs = 0.0; // pixels readback of last frame, not included in frame time
+        int mDrawCalls = 0; // last frame
+        int mMismatchedPixels = -1; // compared to golden frame, -1 if there is no golden frame
+    };
+
+    // public for convenience, should not be modified directly
+    std::vector<CaptureShot> mShots;
+    std::string mOutputDirectory;
+    Timespan mFrameDelta {16}; // fixed game update time step while capturing
+    int mWarmupFrames = 30; // frames rendered before measuring, lets caches and animations settle
+    int mMeasureFrames = 60;
+    int mPixelTolerance = 8; // max per channel difference when comparing against golden frame
+
+public:
+    // Load capture script and start capturing
+    // @param scriptFileName: Script file name
+    bool Initialize(const char* scriptFileName);
+    void Deinit();
+
+    // Setup camera for current shot, should be called after game update
+    void UpdateFrame();
+
+    // Collect timings of rendered frame, should be called after render frame
+    void ProcessFrame();
+
+    // Grab frame pixels for current shot, should be called before present
+    void ReadFramePixels();
+
+    // Test whether capture is running and pixels of current frame should be read back
+    bool IsCaptureActive() const;
+    bool IsFramePixelsRequested() const;
+
+private:
+    void FinishShot();
+    void FinishCapture();
+    int CompareWithGoldenFrame(const std::string& goldenFilePath) const;
+
+private:
+    PixelsArray mFramePixels;
+    int mCurrentShot = 0;
+    int mShotFrame = 0;
+};
+
+extern FrameCapture gFrameCapture;
\ No newline at end of file
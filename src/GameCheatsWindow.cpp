@@ -48,7 +48,22 @@ void GameCheatsWindow::DoUI(Timespan deltaTime)
     }
 
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Frame Time: %.3f ms (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
-    ImGui::Text("Block chunks drawn: %d", gRenderManager.mMapRenderer.mRenderStats.mBlockChunksDrawnCount);
+    ImGui::Text("Block chunks drawn: %d in %d draw calls (culling %.3f ms)", 
+        gRenderManager.mMapRenderer.mRenderStats.mBlockChunksDrawnCount,
+        gRenderManager.mMapRenderer.mRenderStats.mCityMeshDrawCallsCount,
+        gRenderManager.mMapRenderer.mRenderStats.mCityMeshCullingTimeMs);
+    ImGui::Text("City mesh triangles drawn: %d, layer bands occluded: %d", 
+        gRenderManager.mMapRenderer.mRenderStats.mCityMeshTrianglesCount,
+        gRenderManager.mMapRenderer.mRenderStats.mLayerBandsOccludedCount);
+    ImGui::Text("Objects extracted: %d, culled: %d (%.3f ms)", gRenderManager.mMapRenderer.mRenderStats.mObjectsExtractedCount, 
+        gRenderManager.mMapRenderer.mRenderStats.mObjectsCulledCount,
+        gRenderManager.mMapRenderer.mRenderStats.mExtractionTimeMs);
+    ImGui::Text("Sprites drawn: %d", gRenderManager.mMapRenderer.mRenderStats.mSpritesDrawnCount);
+    ImGui::Text("Render commands: %d (recording %.3f ms)", gRenderManager.mMapRenderer.mRenderStats.mRenderCommandsCount,
+        gRenderManager.mMapRenderer.mRenderStats.mRecordingTimeMs);
+    ImGui::Text("Draw calls: %d, state changes issued: %d, skipped: %d", gGraphicsDevice.mFrameStats.mDrawCalls,
+        gGraphicsDevice.mFrameStats.GetIssuedCount(), 
+        gGraphicsDevice.mFrameStats.GetSkippedCount());
     
     // pedestrian stats
     if (Pedestrian* pedestrian = gCarnageGame.mHumanSlot[0].mCharPedestrian)
@@ -151,6 +166,21 @@ void GameCheatsWindow::DoUI(Timespan deltaTime)
         }
     }
 
+    if (ImGui::CollapsingHeader("Snapshot"))
+    {
+        if (ImGui::Button("Capture"))
+        {
+            mWorldSnapshot.Capture();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Restore") && !mWorldSnapshot.IsNull())
+        {
+            mWorldSnapshot.Restore();
+        }
+        ImGui::Text("Capture time: %.3f ms", mWorldSnapshot.mCaptureTimeMs);
+        ImGui::Text("Restore time: %.3f ms", mWorldSnapshot.mRestoreTimeMs);
+    }
+
     ImGui::End();
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DebugWindow.h"
+#include "WorldSnapshot.h"
 
 class GameCheatsWindow: public DebugWindow
 {
@@ -19,6 +20,9 @@ private:
     void DoUI(Timespan deltaTime) override;
 
     void CreateCarNearby(CarStyle* carStyle, Pedestrian* pedestrian);
+
+private:
+    WorldSnapshot mWorldSnapshot;
 };
 
 extern GameCheatsWindow gGameCheatsWindow;
\ No newline at end of file
@@ -57,12 +57,38 @@
 // forwards
 class Pedestrian;
 class Vehicle;
+class WorldSnapshot;
 
 // some game objects has null identifier, they are dacals, projectiles and short-lived effects
 #define GAMEOBJECT_ID_NULL 0
 
 using GameObjectID = unsigned int;
 
+// weak reference to gameobject, packs slot index and slot generation in 32 bits,
+// resolved via GameObjectsManager in constant time and turns null once object is destroyed or queued for deletion
+struct GameObjectHandle
+{
+public:
+    static const unsigned int MaxSlots = 0xFFFF;
+    static const unsigned int GenerationMask = 0xFFFF;
+
+    GameObjectHandle() = default;
+    GameObjectHandle(int slotIndex, unsigned int generation)
+        : mValue((static_cast<unsigned int>(slotIndex) & MaxSlots) | ((generation & GenerationMask) << 16))
+    {
+    }
+    inline int GetSlotIndex() const { return static_cast<int>(mValue & MaxSlots); }
+    inline unsigned int GetGeneration() const { return mValue >> 16; }
+    // generations starts from one so valid handle is never zero
+    inline bool IsNull() const { return mValue == 0; }
+    inline void SetNull() { mValue = 0; }
+    inline bool operator == (const GameObjectHandle& rhs) const { return mValue == rhs.mValue; }
+    inline bool operator != (const GameObjectHandle& rhs) const { return mValue != rhs.mValue; }
+
+public:
+    unsigned int mValue = 0;
+};
+
 // enums all possible gameobject types
 enum eGameObjectType
 {
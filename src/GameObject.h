@@ -17,6 +17,9 @@ public:
 public:
     virtual ~GameObject();
 
+    // get weak reference to gameobject, it is null until object gets registered in GameObjectsManager
+    inline GameObjectHandle GetHandle() const { return mHandle; }
+
     // draw gameobject
     virtual void DrawFrame(SpriteBatch& spriteBatch)
     {
@@ -37,4 +40,5 @@ private:
     // internal stuff that can be touched only by PedestrianManager
     cxx::intrusive_node<GameObject> mObjectsNode; // updatable and drawable entities
     cxx::intrusive_node<GameObject> mDeleteObjectsNode; // to remove queue
+    GameObjectHandle mHandle; // slot in objects lookup table
 };
\ No newline at end of file
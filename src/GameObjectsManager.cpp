@@ -4,6 +4,8 @@
 #include "Pedestrian.h"
 #include "PhysicsComponents.h"
 #include "GameMapManager.h"
+#include "PhysicsManager.h"
+#include "WorldSnapshot.h"
 
 GameObjectsManager gGameObjectsManager;
 
@@ -28,26 +30,37 @@ bool GameObjectsManager::Initialize()
 
 void GameObjectsManager::Deinit()
 {
-    DestroyObjectsInList(mDeleteList);
-    DestroyObjectsInList(mObjectsList);
+    DestroyAllObjects();
 
     debug_assert(!mCarsList.has_elements());
     debug_assert(!mPedestriansList.has_elements());
+    debug_assert(mObjectIDsCount == 0);
+    debug_assert(mPedestriansHotData.GetCount() == 0);
 }
 
 void GameObjectsManager::UpdateFrame(Timespan deltaTime)
 {
     DestroyPendingObjects();
     
-    // update pedestrians
-    for (Pedestrian* currentPed: mPedestriansList) // warning: dont add or remove peds during this loop
+    double pedestriansStartTime = gSystem.GetSysSeconds();
+
+    // update pedestrians in creation order, peds created during update are appended to hot arrays
+    // and get updated on same frame
+    for (int islot = 0; islot < mPedestriansHotData.GetCount(); ++islot)
     {
-        if (mDeleteList.contains(&currentPed->mDeleteObjectsNode))
+        Pedestrian* currentPed = mPedestriansHotData.mPedestrians[islot];
+        if (currentPed == nullptr || mDeleteList.contains(&currentPed->mDeleteObjectsNode))
             continue;
 
         currentPed->UpdateFrame(deltaTime);
     }
 
+    // damage lands after all pedestrians are updated, unlike before batching when it was applied
+    // during attacker update
+    ProcessMeleeAttacks();
+
+    mPedestriansUpdateTimeMs = (gSystem.GetSysSeconds() - pedestriansStartTime) * 1000.0;
+
     // update cars    
     for (Vehicle* currentCar: mCarsList) // warning: dont add or remove cars during this loop
     {
@@ -62,6 +75,55 @@ void GameObjectsManager::DebugDraw()
 {
 }
 
+void GameObjectsManager::CollectDrawData()
+{
+    mPedestriansHotData.CollectDrawData();
+}
+
+void GameObjectsManager::QueueMeleeAttack(Pedestrian* attacker, eWeaponType weapon, const glm::vec2& pointA, const glm::vec2& pointB)
+{
+    debug_assert(attacker);
+
+    MeleeAttack& attack = mMeleeAttacks.emplace_back();
+    attack.mAttacker = attacker->GetHandle();
+    attack.mWeapon = weapon;
+    attack.mPointA = pointA;
+    attack.mPointB = pointB;
+}
+
+void GameObjectsManager::ProcessMeleeAttacks()
+{
+    if (mMeleeAttacks.empty())
+        return;
+
+    PhysicsLinecastBatch linecastBatch;
+    for (const MeleeAttack& currAttack: mMeleeAttacks)
+    {
+        linecastBatch.AddLinecast(currAttack.mPointA, currAttack.mPointB);
+    }
+    gPhysics.QueryObjectsLinecast(linecastBatch);
+
+    for (int icurrAttack = 0, numAttacks = (int) mMeleeAttacks.size(); icurrAttack < numAttacks; ++icurrAttack)
+    {
+        const MeleeAttack& currAttack = mMeleeAttacks[icurrAttack];
+        Pedestrian* attacker = GetPedestrianByHandle(currAttack.mAttacker);
+        if (attacker == nullptr)
+            continue;
+
+        for (int icurrHit = 0; icurrHit < linecastBatch.mQueries[icurrAttack].mHitsCount; ++icurrHit)
+        {
+            PedPhysicsComponent* pedBody = linecastBatch.GetHit(icurrAttack, icurrHit).mPedComponent;
+            if (pedBody == nullptr || pedBody->mReferencePed == attacker) // ignore self
+                continue; 
+
+            // todo: check distance in y direction
+
+            pedBody->mReferencePed->ReceiveDamage(currAttack.mWeapon, attacker);
+        }
+    }
+    mMeleeAttacks.clear();
+}
+
 Pedestrian* GameObjectsManager::CreatePedestrian(const glm::vec3& startPosition, cxx::angle_t startRotation)
 {
     GameObjectID pedestrianID = GenerateUniqueID();
@@ -69,11 +131,19 @@ Pedestrian* GameObjectsManager::CreatePedestrian(const glm::vec3& startPosition,
     Pedestrian* instance = mPedestriansPool.create(pedestrianID);
     debug_assert(instance);
 
+    if (!RegisterObject(instance))
+    {
+        mPedestriansPool.destroy(instance);
+        return nullptr;
+    }
+
     mPedestriansList.insert(&instance->mPedsListNode);
     mObjectsList.insert(&instance->mObjectsNode);
+    mPedestriansHotData.AddPedestrian(instance);
 
     // init
     instance->Spawn(startPosition, startRotation);
+    mPedestriansHotData.CollectDrawData(instance->mHotSlot);
     return instance;
 }
 
@@ -87,6 +157,12 @@ Vehicle* GameObjectsManager::CreateCar(const glm::vec3& startPosition, cxx::angl
     Vehicle* instance = mCarsPool.create(carID);
     debug_assert(instance);
 
+    if (!RegisterObject(instance))
+    {
+        mCarsPool.destroy(instance);
+        return nullptr;
+    }
+
     mCarsList.insert(&instance->mCarsListNode);
     mObjectsList.insert(&instance->mObjectsNode);
 
@@ -112,37 +188,55 @@ Vehicle* GameObjectsManager::CreateCar(const glm::vec3& position, cxx::angle_t c
 
 Vehicle* GameObjectsManager::GetCarByID(GameObjectID objectID) const
 {
-    for (const Vehicle* curr: mCarsList)
-    {
-        if (curr->mObjectID == objectID && !mDeleteList.contains(&curr->mDeleteObjectsNode))
-        {
-            return const_cast<Vehicle*>(curr);
-        }
-    }
+    GameObject* object = GetGameObjectByID(objectID);
+    if (object && object->mObjectTypeID == eGameObjectType_Car)
+        return static_cast<Vehicle*>(object);
+
     return nullptr;
 }
 
 Pedestrian* GameObjectsManager::GetPedestrianByID(GameObjectID objectID) const
 {
-    for (const Pedestrian* curr: mPedestriansList)
-    {
-        if (curr->mObjectID == objectID && !mDeleteList.contains(&curr->mDeleteObjectsNode))
-        {
-            return const_cast<Pedestrian*>(curr);
-        }
-    }
+    GameObject* object = GetGameObjectByID(objectID);
+    if (object && object->mObjectTypeID == eGameObjectType_Pedestrian)
+        return static_cast<Pedestrian*>(object);
+
     return nullptr;
 }
 
 GameObject* GameObjectsManager::GetGameObjectByID(GameObjectID objectID) const
 {
-    for (const GameObject* curr: mObjectsList)
-    {
-        if (curr->mObjectID == objectID && !mDeleteList.contains(&curr->mDeleteObjectsNode))
-        {
-            return const_cast<GameObject*>(curr);
-        }
-    }
+    GameObject* object = FindObjectByID(objectID);
+    if (object && !mDeleteList.contains(&object->mDeleteObjectsNode))
+        return object;
+
+    return nullptr;
+}
+
+Vehicle* GameObjectsManager::GetCarByHandle(GameObjectHandle handle) const
+{
+    GameObject* object = GetGameObjectByHandle(handle);
+    if (object && object->mObjectTypeID == eGameObjectType_Car)
+        return static_cast<Vehicle*>(object);
+
+    return nullptr;
+}
+
+Pedestrian* GameObjectsManager::GetPedestrianByHandle(GameObjectHandle handle) const
+{
+    GameObject* object = GetGameObjectByHandle(handle);
+    if (object && object->mObjectTypeID == eGameObjectType_Pedestrian)
+        return static_cast<Pedestrian*>(object);
+
+    return nullptr;
+}
+
+GameObject* GameObjectsManager::GetGameObjectByHandle(GameObjectHandle handle) const
+{
+    GameObject* object = FindObjectByHandle(handle);
+    if (object && !mDeleteList.contains(&object->mDeleteObjectsNode))
+        return object;
+
     return nullptr;
 }
 
@@ -154,6 +248,12 @@ void GameObjectsManager::MarkForDeletion(GameObject* object)
     }
 }
 
+bool GameObjectsManager::IsMarkedForDeletion(const GameObject* object) const
+{
+    debug_assert(object);
+    return mDeleteList.contains(&object->mDeleteObjectsNode);
+}
+
 void GameObjectsManager::DestroyGameObject(GameObject* object)
 {
     if (object == nullptr)
@@ -172,6 +272,8 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
         mObjectsList.remove(&object->mObjectsNode);
     }
 
+    UnregisterObject(object);
+
     switch (object->mObjectTypeID)
     {
         case eGameObjectType_Pedestrian:
@@ -179,6 +281,7 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
             Pedestrian* pedestrian = static_cast<Pedestrian*>(object);
 
             mPedestriansList.remove(&pedestrian->mPedsListNode);
+            mPedestriansHotData.RemovePedestrian(pedestrian->mHotSlot);
             mPedestriansPool.destroy(pedestrian);
         }
         break;
@@ -204,6 +307,141 @@ void GameObjectsManager::DestroyGameObject(GameObject* object)
     }
 }
 
+void GameObjectsManager::DestroyAllObjects()
+{
+    mMeleeAttacks.clear();
+
+    // pedestrians go first, they leave cars on destroy
+    while (mPedestriansList.has_elements())
+    {
+        DestroyGameObject(mPedestriansList.get_head_node()->get_element());
+    }
+    DestroyObjectsInList(mDeleteList);
+    DestroyObjectsInList(mObjectsList);
+
+    mPedestriansHotData.CompactSlots();
+}
+
+void GameObjectsManager::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    snapshot.Write(mIDsCounter);
+
+    // objects queued for deletion are not saved
+    int numObjects = 0;
+    for (const GameObject* currObject: mObjectsList)
+    {
+        if (!mDeleteList.contains(&currObject->mDeleteObjectsNode))
+        {
+            ++numObjects;
+        }
+    }
+    snapshot.Write(numObjects);
+
+    // headers of all objects go first so cross references could be resolved on load
+    const StyleData& styleData = gGameMap.mStyleData;
+    for (const GameObject* currObject: mObjectsList)
+    {
+        if (mDeleteList.contains(&currObject->mDeleteObjectsNode))
+            continue;
+
+        snapshot.Write(currObject->mObjectTypeID);
+        snapshot.Write(currObject->mObjectID);
+        if (currObject->mObjectTypeID == eGameObjectType_Car)
+        {
+            const Vehicle* car = static_cast<const Vehicle*>(currObject);
+            snapshot.Write(static_cast<int>(car->mCarStyle - styleData.mCars.data()));
+        }
+    }
+
+    for (const GameObject* currObject: mObjectsList)
+    {
+        if (mDeleteList.contains(&currObject->mDeleteObjectsNode))
+            continue;
+
+        if (currObject->mObjectTypeID == eGameObjectType_Pedestrian)
+        {
+            static_cast<const Pedestrian*>(currObject)->SaveSnapshot(snapshot);
+        }
+        else if (currObject->mObjectTypeID == eGameObjectType_Car)
+        {
+            static_cast<const Vehicle*>(currObject)->SaveSnapshot(snapshot);
+        }
+    }
+}
+
+bool GameObjectsManager::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    debug_assert(!mObjectsList.has_elements());
+
+    int numObjects = 0;
+    if (!snapshot.Read(mIDsCounter) || !snapshot.Read(numObjects))
+        return false;
+
+    StyleData& styleData = gGameMap.mStyleData;
+
+    std::vector<GameObject*> objects;
+    objects.reserve(numObjects);
+    for (int icurr = 0; icurr < numObjects; ++icurr)
+    {
+        eGameObjectType objectType;
+        GameObjectID objectID;
+        if (!snapshot.Read(objectType) || !snapshot.Read(objectID))
+            return false;
+
+        if (objectType == eGameObjectType_Pedestrian)
+        {
+            Pedestrian* instance = mPedestriansPool.create(objectID);
+            debug_assert(instance);
+
+            if (!RegisterObject(instance))
+            {
+                mPedestriansPool.destroy(instance);
+                return false;
+            }
+
+            mPedestriansList.insert(&instance->mPedsListNode);
+            mObjectsList.insert(&instance->mObjectsNode);
+            mPedestriansHotData.AddPedestrian(instance);
+            objects.push_back(instance);
+            continue;
+        }
+
+        if (objectType == eGameObjectType_Car)
+        {
+            int carStyleIndex = 0;
+            if (!snapshot.Read(carStyleIndex) || carStyleIndex < 0 || carStyleIndex >= (int) styleData.mCars.size())
+                return false;
+
+            Vehicle* instance = mCarsPool.create(objectID);
+            debug_assert(instance);
+
+            if (!RegisterObject(instance))
+            {
+                mCarsPool.destroy(instance);
+                return false;
+            }
+
+            mCarsList.insert(&instance->mCarsListNode);
+            mObjectsList.insert(&instance->mObjectsNode);
+            instance->mCarStyle = &styleData.mCars[carStyleIndex];
+            objects.push_back(instance);
+            continue;
+        }
+        return false;
+    }
+
+    for (GameObject* currObject: objects)
+    {
+        bool isLoaded = (currObject->mObjectTypeID == eGameObjectType_Pedestrian) ? 
+            static_cast<Pedestrian*>(currObject)->LoadSnapshot(snapshot) : 
+            static_cast<Vehicle*>(currObject)->LoadSnapshot(snapshot);
+        if (!isLoaded)
+            return false;
+    }
+    CollectDrawData();
+    return true;
+}
+
 void GameObjectsManager::DestroyObjectsInList(cxx::intrusive_list<GameObject>& objectsList)
 {
     while (objectsList.has_elements())
@@ -218,6 +456,167 @@ void GameObjectsManager::DestroyObjectsInList(cxx::intrusive_list<GameObject>& o
 void GameObjectsManager::DestroyPendingObjects()
 {
     DestroyObjectsInList(mDeleteList);
+
+    // removed pedestrians leave empty hot slots, shift them all at once
+    mPedestriansHotData.CompactSlots();
+}
+
+bool GameObjectsManager::RegisterObject(GameObject* object)
+{
+    debug_assert(object);
+    debug_assert(object->mHandle.IsNull());
+    debug_assert(FindObjectByID(object->mObjectID) == nullptr);
+
+    int slotIndex = 0;
+    if (mFreeObjectSlots.empty())
+    {
+        // slot index is packed into 16 bits of handle, next slot would alias first one
+        if (mObjectSlots.size() >= GameObjectHandle::MaxSlots)
+        {
+            gConsole.LogMessage(eLogMessage_Error, "Cannot create gameobject, out of object handle slots (%d)", GameObjectHandle::MaxSlots);
+            return false;
+        }
+        slotIndex = static_cast<int>(mObjectSlots.size());
+        mObjectSlots.emplace_back();
+    }
+    else
+    {
+        slotIndex = mFreeObjectSlots.back();
+        mFreeObjectSlots.pop_back();
+    }
+    ObjectSlot& objectSlot = mObjectSlots[slotIndex];
+    objectSlot.mObject = object;
+    object->mHandle = GameObjectHandle(slotIndex, objectSlot.mGeneration);
+
+    // keep load factor below half
+    int numBuckets = static_cast<int>(mObjectIDsTable.size());
+    if ((mObjectIDsCount + 1) * 2 > numBuckets)
+    {
+        ResizeObjectIDsTable(std::max(numBuckets * 2, 64));
+    }
+
+    int bucketMask = static_cast<int>(mObjectIDsTable.size()) - 1;
+    int bucketIndex = GetObjectIDsTableBucket(object->mObjectID);
+    for (; mObjectIDsTable[bucketIndex].mObjectID != GAMEOBJECT_ID_NULL; bucketIndex = (bucketIndex + 1) & bucketMask)
+    {
+    }
+    ObjectIDsBucket& bucket = mObjectIDsTable[bucketIndex];
+    bucket.mObjectID = object->mObjectID;
+    bucket.mHandle = object->mHandle;
+    ++mObjectIDsCount;
+    return true;
+}
+
+void GameObjectsManager::UnregisterObject(GameObject* object)
+{
+    debug_assert(object);
+    if (object->mHandle.IsNull())
+    {
+        debug_assert(false);
+        return;
+    }
+
+    // find bucket
+    int bucketMask = static_cast<int>(mObjectIDsTable.size()) - 1;
+    int bucketIndex = GetObjectIDsTableBucket(object->mObjectID);
+    for (; mObjectIDsTable[bucketIndex].mObjectID != object->mObjectID; bucketIndex = (bucketIndex + 1) & bucketMask)
+    {
+        debug_assert(mObjectIDsTable[bucketIndex].mObjectID != GAMEOBJECT_ID_NULL);
+    }
+
+    // shift following buckets of same probe sequence back, so lookups never stop at hole
+    for (int nextIndex = (bucketIndex + 1) & bucketMask; mObjectIDsTable[nextIndex].mObjectID != GAMEOBJECT_ID_NULL; 
+        nextIndex = (nextIndex + 1) & bucketMask)
+    {
+        int desiredIndex = GetObjectIDsTableBucket(mObjectIDsTable[nextIndex].mObjectID);
+        // check whether desired bucket lies cyclically outside of (bucketIndex, nextIndex]
+        if (((nextIndex - desiredIndex) & bucketMask) >= ((nextIndex - bucketIndex) & bucketMask))
+        {
+            mObjectIDsTable[bucketIndex] = mObjectIDsTable[nextIndex];
+            bucketIndex = nextIndex;
+        }
+    }
+    mObjectIDsTable[bucketIndex] = ObjectIDsBucket();
+    --mObjectIDsCount;
+
+    // handles to destroyed object resolve to null from now on
+    int slotIndex = object->mHandle.GetSlotIndex();
+    ObjectSlot& objectSlot = mObjectSlots[slotIndex];
+    debug_assert(objectSlot.mObject == object);
+    objectSlot.mObject = nullptr;
+    objectSlot.mGeneration = (objectSlot.mGeneration + 1) & GameObjectHandle::GenerationMask;
+    if (objectSlot.mGeneration == 0)
+    {
+        objectSlot.mGeneration = 1;
+    }
+    mFreeObjectSlots.push_back(slotIndex);
+    object->mHandle.SetNull();
+}
+
+GameObject* GameObjectsManager::FindObjectByID(GameObjectID objectID) const
+{
+    if (objectID == GAMEOBJECT_ID_NULL || mObjectIDsCount == 0)
+        return nullptr;
+
+    int bucketMask = static_cast<int>(mObjectIDsTable.size()) - 1;
+    for (int bucketIndex = GetObjectIDsTableBucket(objectID); ; bucketIndex = (bucketIndex + 1) & bucketMask)
+    {
+        const ObjectIDsBucket& bucket = mObjectIDsTable[bucketIndex];
+        if (bucket.mObjectID == GAMEOBJECT_ID_NULL)
+            return nullptr;
+
+        if (bucket.mObjectID != objectID)
+            continue;
+
+        // slot must not be reused since object was registered
+        GameObject* object = FindObjectByHandle(bucket.mHandle);
+        debug_assert(object && object->mObjectID == objectID);
+        return object;
+    }
+}
+
+GameObject* GameObjectsManager::FindObjectByHandle(GameObjectHandle handle) const
+{
+    if (handle.IsNull())
+        return nullptr;
+
+    int slotIndex = handle.GetSlotIndex();
+    if (slotIndex >= static_cast<int>(mObjectSlots.size()))
+        return nullptr;
+
+    const ObjectSlot& objectSlot = mObjectSlots[slotIndex];
+    if (objectSlot.mGeneration != handle.GetGeneration())
+        return nullptr;
+
+    return objectSlot.mObject;
+}
+
+int GameObjectsManager::GetObjectIDsTableBucket(GameObjectID objectID) const
+{
+    // identifiers are sequential so lower bits are spread evenly without extra hashing
+    return static_cast<int>(objectID & (mObjectIDsTable.size() - 1));
+}
+
+void GameObjectsManager::ResizeObjectIDsTable(int numBuckets)
+{
+    debug_assert((numBuckets & (numBuckets - 1)) == 0);
+
+    std::vector<ObjectIDsBucket> prevTable;
+    prevTable.swap(mObjectIDsTable);
+    mObjectIDsTable.resize(numBuckets);
+
+    int bucketMask = numBuckets - 1;
+    for (const ObjectIDsBucket& currBucket: prevTable)
+    {
+        if (currBucket.mObjectID == GAMEOBJECT_ID_NULL)
+            continue;
+
+        int bucketIndex = GetObjectIDsTableBucket(currBucket.mObjectID);
+        for (; mObjectIDsTable[bucketIndex].mObjectID != GAMEOBJECT_ID_NULL; bucketIndex = (bucketIndex + 1) & bucketMask)
+        {
+        }
+        mObjectIDsTable[bucketIndex] = currBucket;
+    }
 }
 
 GameObjectID GameObjectsManager::GenerateUniqueID()
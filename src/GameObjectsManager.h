@@ -2,6 +2,7 @@
 
 #include "Pedestrian.h"
 #include "Vehicle.h"
+#include "PedestriansHotData.h"
 
 // define game objects manager class
 class GameObjectsManager final: public cxx::noncopyable
@@ -12,6 +13,9 @@ public:
     cxx::intrusive_list<GameObject> mDeleteList;
     cxx::intrusive_list<Pedestrian> mPedestriansList;
     cxx::intrusive_list<Vehicle> mCarsList;
+    PedestriansHotData mPedestriansHotData;
+
+    double mPedestriansUpdateTimeMs = 0.0; // last frame
 
 public:
     ~GameObjectsManager();
@@ -21,6 +25,9 @@ public:
     void UpdateFrame(Timespan deltaTime);
     void DebugDraw();
 
+    // copy draw data of pedestrians into hot arrays, should be called after game update
+    void CollectDrawData();
+
     // add pedestrian to map at specific location
     // @param position: Real world position
     // @param startRotation: Initial rotation
@@ -34,12 +41,20 @@ public:
     Vehicle* CreateCar(const glm::vec3& startPosition, cxx::angle_t startRotation, CarStyle* carStyle);
     Vehicle* CreateCar(const glm::vec3& startPosition, cxx::angle_t startRotation, eCarModel carModel);
 
-    // find gameobject by its unique identifier
+    // find gameobject by its unique identifier, constant time
+    // objects queued for deletion are not returned
     // @param objectID: Unique identifier
     Vehicle* GetCarByID(GameObjectID objectID) const;
     Pedestrian* GetPedestrianByID(GameObjectID objectID) const;
     GameObject* GetGameObjectByID(GameObjectID objectID) const;
 
+    // resolve weak reference to gameobject, constant time
+    // objects queued for deletion are not returned
+    // @param handle: Gameobject handle
+    Vehicle* GetCarByHandle(GameObjectHandle handle) const;
+    Pedestrian* GetPedestrianByHandle(GameObjectHandle handle) const;
+    GameObject* GetGameObjectByHandle(GameObjectHandle handle) const;
+
     // will immediately destroy gameobject, don't call this mehod while UpdateFrame
     // @param object: Object to destroy
     void DestroyGameObject(GameObject* object);
@@ -48,15 +63,77 @@ public:
     // @param object: Object to queue
     void MarkForDeletion(GameObject* object);
 
+    // test whether gameobject is queued for deletion
+    // @param object: Object to test
+    bool IsMarkedForDeletion(const GameObject* object) const;
+
+    // will immediately destroy all gameobjects, don't call this method while UpdateFrame
+    void DestroyAllObjects();
+
+    // write or read all gameobjects, used by world snapshots
+    // objects are recreated with same identifiers, existing objects must be destroyed before load
+    // @param snapshot: Snapshot data
+    void SaveSnapshot(WorldSnapshot& snapshot) const;
+    bool LoadSnapshot(WorldSnapshot& snapshot);
+
+    // queue fists attack, hits of all attacks queued during pedestrians update are resolved at once,
+    // victim updated later than attacker on same frame takes damage only after its own update
+    // @param attacker: Attacking pedestrian
+    // @param weapon: Weapon type
+    // @param pointA, pointB: Attack line
+    void QueueMeleeAttack(Pedestrian* attacker, eWeaponType weapon, const glm::vec2& pointA, const glm::vec2& pointB);
+
 private:
     bool CreateStartupObjects();
     void DestroyObjectsInList(cxx::intrusive_list<GameObject>& objectsList);
     void DestroyPendingObjects();
     GameObjectID GenerateUniqueID();
 
+    // add or remove gameobject from lookup table, should be called on create and destroy
+    // @param object: Object
+    // @returns false if all handle slots are in use, object must be destroyed then
+    bool RegisterObject(GameObject* object);
+    void UnregisterObject(GameObject* object);
+
+    // lookup table helpers
+    GameObject* FindObjectByID(GameObjectID objectID) const;
+    GameObject* FindObjectByHandle(GameObjectHandle handle) const;
+    int GetObjectIDsTableBucket(GameObjectID objectID) const;
+    void ResizeObjectIDsTable(int numBuckets);
+
+    // process all queued attacks with single batched physics query
+    void ProcessMeleeAttacks();
+
 private:
+    struct MeleeAttack
+    {
+        GameObjectHandle mAttacker; // attacker could be queued for deletion until attacks are processed
+        eWeaponType mWeapon = eWeaponType_Fists;
+        glm::vec2 mPointA;
+        glm::vec2 mPointB;
+    };
+    std::vector<MeleeAttack> mMeleeAttacks;
+
     GameObjectID mIDsCounter = 0;
 
+    // objects lookup table, slot of destroyed object is reused and its generation gets incremented
+    struct ObjectSlot
+    {
+        GameObject* mObject = nullptr;
+        unsigned int mGeneration = 1; // never zero, see GameObjectHandle
+    };
+    std::vector<ObjectSlot> mObjectSlots;
+    std::vector<int> mFreeObjectSlots;
+
+    // open addressing hash table with linear probing, maps identifiers to object slots
+    struct ObjectIDsBucket
+    {
+        GameObjectID mObjectID = GAMEOBJECT_ID_NULL; // null if bucket is empty
+        GameObjectHandle mHandle;
+    };
+    std::vector<ObjectIDsBucket> mObjectIDsTable; // number of buckets is power of two
+    int mObjectIDsCount = 0;
+
     // objects pools
     cxx::object_pool<Pedestrian> mPedestriansPool;
     cxx::object_pool<Vehicle> mCarsPool;
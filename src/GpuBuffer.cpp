@@ -66,6 +66,10 @@ void GpuBuffer::SetUnbound()
     {
         mGraphicsContext.mCurrentBuffers[mContent] = nullptr;
     }
+    if (mGraphicsContext.mVertexFormatBuffer == this)
+    {
+        mGraphicsContext.mVertexFormatBuffer = nullptr;
+    }
 }
 
 bool GpuBuffer::Setup(eBufferUsage bufferUsage, unsigned int bufferLength, const void* dataBuffer)
@@ -94,6 +98,7 @@ bool GpuBuffer::Setup(eBufferUsage bufferUsage, unsigned int bufferLength, const
         else
         {
             ::memcpy(pMappedData, dataBuffer, bufferLength);
+            mGraphicsContext.mFrameStats.mBufferBytesUploaded += bufferLength;
         }
 
         GLboolean unmapResult = ::glUnmapBuffer(bufferTargetGL);
@@ -172,12 +177,13 @@ bool GpuBuffer::SubData(unsigned int dataOffset, unsigned int dataLength, const
     }
 
     debug_assert(dataLength && dataSource);
-    debug_assert(dataOffset + dataLength < mBufferCapacity);
+    debug_assert(dataOffset + dataLength <= mBufferCapacity);
 
     ScopedBufferBinder scopedBind (mGraphicsContext, this);
     GLenum bufferTargetGL = EnumToGL(mContent);
     ::glBufferSubData(bufferTargetGL, dataOffset, dataLength, dataSource);
     glCheckError();
+    mGraphicsContext.mFrameStats.mBufferBytesUploaded += dataLength;
 
     return true;
 }
@@ -212,6 +212,48 @@ void GpuProgram::SetCustomUniform(GpuVariableLocation constantLocation, const gl
 
 bool GpuProgram::CompileSourceCode(const char* shaderSource)
 {
+    debug_assert(shaderSource);
+    return SetupProgram(shaderSource, 0, nullptr, 0);
+}
+
+bool GpuProgram::LoadProgramBinary(unsigned int binaryFormat, const void* binaryData, int binaryLength)
+{
+    debug_assert(binaryData && binaryLength > 0);
+    return SetupProgram(nullptr, binaryFormat, binaryData, binaryLength);
+}
+
+bool GpuProgram::GetProgramBinary(unsigned int& binaryFormat, std::vector<unsigned char>& binaryData) const
+{
+    binaryData.clear();
+    if (!IsProgramCompiled() || !gGraphicsDevice.mCaps.mFeatures[eGraphicsFeature_ProgramBinary])
+        return false;
+
+    GLint binaryLength = 0;
+    ::glGetProgramiv(mResourceHandle, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    glCheckError();
+    if (binaryLength < 1)
+        return false;
+
+    binaryData.resize(binaryLength);
+
+    GLenum binaryFormatGL = 0;
+    ::glGetProgramBinary(mResourceHandle, binaryLength, nullptr, &binaryFormatGL, binaryData.data());
+    glCheckError();
+
+    binaryFormat = binaryFormatGL;
+    return true;
+}
+
+bool GpuProgram::SetupProgram(const char* shaderSource, unsigned int binaryFormat, const void* binaryData, int binaryLength)
+{
+    auto BuildProgram = [&](GpuProgramHandle targetHandle)
+    {
+        if (shaderSource)
+            return CompileSourceCode(targetHandle, shaderSource);
+
+        return LoadProgramBinary(targetHandle, binaryFormat, binaryData, binaryLength);
+    };
+
     // set unbound
     if (this == mGraphicsContext.mCurrentProgram)
     {
@@ -226,7 +268,7 @@ bool GpuProgram::CompileSourceCode(const char* shaderSource)
         programHandleGL = ::glCreateProgram();
         glCheckError();
 
-        isSuccessed = CompileSourceCode(programHandleGL, shaderSource);
+        isSuccessed = BuildProgram(programHandleGL);
         if (!isSuccessed)
         {
             // destroy temporary program
@@ -243,7 +285,7 @@ bool GpuProgram::CompileSourceCode(const char* shaderSource)
     }
     else
     {
-        isSuccessed = CompileSourceCode(mResourceHandle, shaderSource);
+        isSuccessed = BuildProgram(mResourceHandle);
     }
 
     if (!isSuccessed)
@@ -322,6 +364,12 @@ bool GpuProgram::CompileSourceCode(GpuProgramHandle targetHandle, const char* pr
     ::glAttachShader(targetHandle, fragmentShader.mHandle);
     glCheckError();
 
+    if (gGraphicsDevice.mCaps.mFeatures[eGraphicsFeature_ProgramBinary])
+    {
+        ::glProgramParameteri(targetHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glCheckError();
+    }
+
     ::glLinkProgram(targetHandle);
     glCheckError();
 
@@ -347,6 +395,22 @@ bool GpuProgram::CompileSourceCode(GpuProgramHandle targetHandle, const char* pr
     return true;
 }
 
+bool GpuProgram::LoadProgramBinary(GpuProgramHandle targetHandle, unsigned int binaryFormat, const void* binaryData, int binaryLength)
+{
+    if (!gGraphicsDevice.mCaps.mFeatures[eGraphicsFeature_ProgramBinary])
+        return false;
+
+    ::glProgramBinary(targetHandle, binaryFormat, binaryData, binaryLength);
+    // driver may reject binary at any time, for example after update, error code is expected then
+    // and caller falls back to compiling from sources, so rely on link status only
+    glClearError();
+
+    GLint linkResultGL;
+    ::glGetProgramiv(targetHandle, GL_LINK_STATUS, &linkResultGL);
+    glCheckError();
+    return linkResultGL != GL_FALSE;
+}
+
 bool GpuProgram::IsUniformExists(eRenderUniform constant) const
 {
     debug_assert(constant < eRenderUniform_COUNT);
@@ -22,6 +22,17 @@ public:
     // @param shaderSource: Source code
     bool CompileSourceCode(const char* shaderSource);
 
+    // Create render program from binary retrieved earlier with same driver
+    // @param binaryFormat: Driver specific binary format
+    // @param binaryData: Program binary
+    // @param binaryLength: Program binary length in bytes
+    bool LoadProgramBinary(unsigned int binaryFormat, const void* binaryData, int binaryLength);
+
+    // Retrieve binary of compiled render program
+    // @param binaryFormat: Output driver specific binary format
+    // @param binaryData: Output program binary
+    bool GetProgramBinary(unsigned int& binaryFormat, std::vector<unsigned char>& binaryData) const;
+
     // Test whether render program is currently activated
     bool IsProgramBound() const;
 
@@ -62,7 +73,9 @@ public:
 
 private:
     // implementation details
+    bool SetupProgram(const char* programSrc, unsigned int binaryFormat, const void* binaryData, int binaryLength);
     bool CompileSourceCode(GpuProgramHandle targetHandle, const char* programSrc);
+    bool LoadProgramBinary(GpuProgramHandle targetHandle, unsigned int binaryFormat, const void* binaryData, int binaryLength);
     void SetUnbound();
 
 private:
@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "GpuRenderTarget.h"
+#include "OpenGLDefs.h"
+#include "GraphicsContext.h"
+
+GpuRenderTarget::GpuRenderTarget(GraphicsContext& graphicsContext)
+    : mGraphicsContext(graphicsContext)
+    , mResourceHandle()
+    , mColorbufferHandle()
+    , mDepthbufferHandle()
+    , mSize()
+{
+    ::glGenFramebuffers(1, &mResourceHandle);
+    glCheckError();
+
+    ::glGenRenderbuffers(1, &mColorbufferHandle);
+    glCheckError();
+
+    ::glGenRenderbuffers(1, &mDepthbufferHandle);
+    glCheckError();
+}
+
+GpuRenderTarget::~GpuRenderTarget()
+{
+    SetUnbound();
+
+    ::glDeleteFramebuffers(1, &mResourceHandle);
+    glCheckError();
+
+    ::glDeleteRenderbuffers(1, &mColorbufferHandle);
+    glCheckError();
+
+    ::glDeleteRenderbuffers(1, &mDepthbufferHandle);
+    glCheckError();
+}
+
+bool GpuRenderTarget::Setup(int sizex, int sizey)
+{
+    debug_assert(sizex > 0 && sizey > 0);
+
+    mSize.x = 0;
+    mSize.y = 0;
+
+    ::glBindRenderbuffer(GL_RENDERBUFFER, mColorbufferHandle);
+    glCheckError();
+    ::glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, sizex, sizey);
+    glCheckError();
+
+    ::glBindRenderbuffer(GL_RENDERBUFFER, mDepthbufferHandle);
+    glCheckError();
+    ::glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, sizex, sizey);
+    glCheckError();
+
+    ::glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glCheckError();
+
+    // attach buffers and restore current binding
+    GpuRenderTarget* currentRenderTarget = mGraphicsContext.mCurrentRenderTarget;
+    ::glBindFramebuffer(GL_FRAMEBUFFER, mResourceHandle);
+    glCheckError();
+    ::glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mColorbufferHandle);
+    glCheckError();
+    ::glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, mDepthbufferHandle);
+    glCheckError();
+
+    GLenum framebufferStatus = ::glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glCheckError();
+
+    ::glBindFramebuffer(GL_FRAMEBUFFER, currentRenderTarget ? currentRenderTarget->mResourceHandle : 0);
+    glCheckError();
+
+    if (framebufferStatus != GL_FRAMEBUFFER_COMPLETE)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Render target is incomplete (0x%04X)", framebufferStatus);
+        return false;
+    }
+
+    mSize.x = sizex;
+    mSize.y = sizey;
+    return true;
+}
+
+bool GpuRenderTarget::IsRenderTargetBound() const
+{
+    return this == mGraphicsContext.mCurrentRenderTarget;
+}
+
+bool GpuRenderTarget::IsRenderTargetInited() const
+{
+    return mSize.x > 0 && mSize.y > 0;
+}
+
+void GpuRenderTarget::SetUnbound()
+{
+    if (this == mGraphicsContext.mCurrentRenderTarget)
+    {
+        ::glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glCheckError();
+
+        mGraphicsContext.mCurrentRenderTarget = nullptr;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "GraphicsDefs.h"
+
+// defines hardware framebuffer object with color and depth renderbuffers
+class GpuRenderTarget final: public cxx::noncopyable
+{
+public:
+    // public for convenience, don't change these fields directly
+    GpuFramebufferHandle mResourceHandle;
+    GpuFramebufferHandle mColorbufferHandle;
+    GpuFramebufferHandle mDepthbufferHandle;
+    Size2D mSize;
+
+public:
+    GpuRenderTarget(GraphicsContext& graphicsContext);
+    ~GpuRenderTarget();
+
+    // Allocate RGBA8 color and 16 bit depth storage, previous content is discarded
+    // @param sizex, sizey: Dimensions
+    bool Setup(int sizex, int sizey);
+
+    // Test whether render target is currently bound for drawing
+    bool IsRenderTargetBound() const;
+
+    // Test whether render target storage is allocated
+    bool IsRenderTargetInited() const;
+
+private:
+    void SetUnbound();
+
+private:
+    GraphicsContext& mGraphicsContext;
+};
\ No newline at end of file
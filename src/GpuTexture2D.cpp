@@ -74,6 +74,10 @@ bool GpuTexture2D::Setup(eTextureFormat textureFormat, int sizex, int sizey, con
     ScopedTexture2DBinder scopedBind(mGraphicsContext, this);
     ::glTexImage2D(GL_TEXTURE_2D, 0, internalFormatGL, mSize.x, mSize.y, 0, formatGL, dataType, sourceData);
     glCheckError();
+    if (sourceData)
+    {
+        mGraphicsContext.mFrameStats.mTextureBytesUploaded += mSize.x * mSize.y * NumBytesPerPixel(mFormat);
+    }
 
     // set default filter and repeat mode for texture
     SetSamplerStateImpl(gGraphicsDevice.mDefaultTextureFilter, gGraphicsDevice.mDefaultTextureWrap);
@@ -137,6 +141,7 @@ bool GpuTexture2D::Upload(int mipLevel, int xoffset, int yoffset, int sizex, int
     ScopedTexture2DBinder scopedBind(mGraphicsContext, this);
     ::glTexSubImage2D(GL_TEXTURE_2D, mipLevel, xoffset, yoffset, sizex, sizey, formatGL, dataType, sourceData);
     glCheckError();
+    mGraphicsContext.mFrameStats.mTextureBytesUploaded += sizex * sizey * NumBytesPerPixel(mFormat);
     return true;
 }
 
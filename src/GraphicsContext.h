@@ -14,6 +14,10 @@ public:
         , mCurrentTextures()
         , mCurrentProgram()
         , mVaoHandle()
+        , mEnabledAttributes()
+        , mVertexFormatBuffer()
+        , mVertexFormatBufferHandle()
+        , mCurrentRenderTarget()
     {
     }
 public:
@@ -31,4 +35,15 @@ public:
     GpuProgram* mCurrentProgram;
     eTextureUnit mCurrentTextureUnit;
     TextureUnitState mCurrentTextures[eTextureUnit_COUNT];
+    GpuRenderTarget* mCurrentRenderTarget; // null if default framebuffer
+
+    // vertex attributes state of vao
+    bool mEnabledAttributes[eVertexAttribute_MAX];
+    // vertex attribute pointers are specified for this buffer and format, they depends on current program also
+    GpuBuffer* mVertexFormatBuffer;
+    GpuBufferHandle mVertexFormatBufferHandle; // buffer may change its handle on resize
+    VertexFormat mVertexFormat;
+
+    // counters of current frame, gpu resources updates them too
+    GraphicsDeviceStats mFrameStats;
 };
\ No newline at end of file
@@ -7,6 +7,7 @@ class GpuProgram;
 class GpuBufferTexture;
 class GpuTexture2D;
 class GpuTextureArray2D;
+class GpuRenderTarget;
 class GraphicsContext;
 
 // internal types
@@ -14,6 +15,8 @@ using GpuProgramHandle = unsigned int;
 using GpuBufferHandle = unsigned int;
 using GpuTextureHandle = unsigned int;
 using GpuVertexArrayHandle = unsigned int;
+using GpuFramebufferHandle = unsigned int;
+using GpuQueryHandle = unsigned int;
 using GpuVariableLocation = int;
 
 // predefined value for unspecified render program variable location
@@ -452,6 +455,11 @@ public:
     unsigned int mBaseOffset = 0; // additional offset in bytes within source vertex buffer, affects on all attribues
 };
 
+const unsigned int Sizeof_VertexFormat = sizeof(VertexFormat);
+
+inline bool operator == (const VertexFormat& a, const VertexFormat& b) { return ::memcmp(&a, &b, Sizeof_VertexFormat) == 0; }
+inline bool operator != (const VertexFormat& a, const VertexFormat& b) { return ::memcmp(&a, &b, Sizeof_VertexFormat) != 0; }
+
 // standard engine vertex definition
 struct Vertex3D_Format: public VertexFormat
 {
@@ -724,6 +732,8 @@ enum eGraphicsFeature
 {
     eGraphicsFeature_NPOT_Textures,
     eGraphicsFeature_ABGR,
+    eGraphicsFeature_ProgramBinary,
+    eGraphicsFeature_TimerQuery,
     eGraphicsFeature_COUNT
 };
 
@@ -736,4 +746,39 @@ public:
     int mMaxArrayTextureLayers;
     int mMaxTextureBufferSize;
     bool mFeatures[eGraphicsFeature_COUNT];
+    std::string mDriverString; // vendor, renderer and version
+};
+
+// counters of state changes issued to driver and skipped as redundant
+struct GraphicsDeviceStats
+{
+public:
+    GraphicsDeviceStats() = default;
+
+    inline int GetIssuedCount() const
+    {
+        return mProgramBinds + mVertexBufferBinds + mVertexFormatChanges + mIndexBufferBinds + mTextureBinds + mRenderStatesChanges;
+    }
+    inline int GetSkippedCount() const
+    {
+        return mProgramBindsSkipped + mVertexBufferBindsSkipped + mVertexFormatChangesSkipped + mIndexBufferBindsSkipped + 
+            mTextureBindsSkipped + mRenderStatesChangesSkipped;
+    }
+public:
+    int mProgramBinds = 0;
+    int mProgramBindsSkipped = 0;
+    int mVertexBufferBinds = 0;
+    int mVertexBufferBindsSkipped = 0;
+    int mVertexFormatChanges = 0;
+    int mVertexFormatChangesSkipped = 0;
+    int mIndexBufferBinds = 0;
+    int mIndexBufferBindsSkipped = 0;
+    int mTextureBinds = 0;
+    int mTextureBindsSkipped = 0;
+    int mRenderStatesChanges = 0;
+    int mRenderStatesChangesSkipped = 0;
+    int mDrawCalls = 0;
+    int mPrimitivesCount = 0;
+    int mBufferBytesUploaded = 0; // vertex and index data
+    int mTextureBytesUploaded = 0;
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "GpuBufferTexture.h"
 #include "GpuTexture2D.h"
 #include "GpuTextureArray2D.h"
+#include "GpuRenderTarget.h"
 
 #define WINDOW_TITLE "Carnage3D"
 
@@ -13,6 +14,24 @@ GraphicsDevice gGraphicsDevice;
 
 //////////////////////////////////////////////////////////////////////////
 
+// get number of primitives produced by specified number of elements
+static int GetPrimitivesCount(ePrimitiveType primitiveType, unsigned int numElements)
+{
+    switch (primitiveType)
+    {
+        case ePrimitiveType_Points: return numElements;
+        case ePrimitiveType_Lines: return numElements / 2;
+        case ePrimitiveType_LineLoop: return numElements;
+        case ePrimitiveType_Triangles: return numElements / 3;
+        case ePrimitiveType_TriangleStrip: 
+        case ePrimitiveType_TriangleFan: return numElements > 2 ? numElements - 2 : 0;
+    }
+    debug_assert(false);
+    return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 // glfw to native input mapping
 static eKeycode GlfwKeycodeToNative(int keycode)
 {
@@ -147,6 +166,13 @@ bool GraphicsDevice::Initialize(int screensizex, int screensizey, bool fullscree
         OPENGL_CONTEXT_MINOR_VERSION,
         gSystem.mConfig.mOpenGLCoreProfile ? "(Core profile)" : "");
 
+    bool offscreen = gSystem.mConfig.mOffscreenRendering;
+    if (offscreen)
+    {
+        fullscreen = false;
+        vsync = false;
+    }
+
     GLFWmonitor* graphicsMonitor = nullptr;
     if (fullscreen)
     {
@@ -175,6 +201,18 @@ bool GraphicsDevice::Initialize(int screensizex, int screensizey, bool fullscree
     ::glfwWindowHint(GLFW_ALPHA_BITS, 8);
     ::glfwWindowHint(GLFW_DEPTH_BITS, 16);
 
+    if (offscreen)
+    {
+        gConsole.LogMessage(eLogMessage_Info, "Offscreen rendering enabled%s", gSystem.mConfig.mOpenGLOSMesaContext ? " (OSMesa context)" : "");
+
+        // window is still required by glfw but is never shown
+        ::glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        if (gSystem.mConfig.mOpenGLOSMesaContext)
+        {
+            ::glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        }
+    }
+
     // create window and set current context
     GLFWwindow* graphicsWindow = ::glfwCreateWindow(screensizex, screensizey, WINDOW_TITLE, graphicsMonitor, nullptr);
     debug_assert(graphicsWindow);
@@ -264,6 +302,35 @@ bool GraphicsDevice::Initialize(int screensizex, int screensizey, bool fullscree
     ::glBindVertexArray(mGraphicsContext.mVaoHandle);
     glCheckError();
 
+    // all attributes are disabled in new vao
+    for (bool& isEnabled: mGraphicsContext.mEnabledAttributes)
+    {
+        isEnabled = false;
+    }
+
+    // frame time queries go before anything that may fail, deinit expects them to be running
+    if (mCaps.mFeatures[eGraphicsFeature_TimerQuery])
+    {
+        ::glGenQueries(CountOf(mFrameTimeQueries), mFrameTimeQueries);
+        glCheckError();
+
+        ::glBeginQuery(GL_TIME_ELAPSED, mFrameTimeQueries[mFrameTimeQueryIndex]);
+        glCheckError();
+    }
+
+    if (offscreen)
+    {
+        mOffscreenRenderTarget = CreateRenderTarget(screensizex, screensizey);
+        if (mOffscreenRenderTarget == nullptr)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot create offscreen framebuffer");
+            Deinit();
+            return false;
+        }
+        // stays bound as default framebuffer for whole session
+        BindRenderTarget(nullptr);
+    }
+
     // scissor test always enabled
     ::glEnable(GL_SCISSOR_TEST);
     glCheckError();
@@ -287,8 +354,11 @@ bool GraphicsDevice::Initialize(int screensizex, int screensizey, bool fullscree
     glCheckError();
 
     // force clear screen at stratup
-    ::glfwSwapBuffers(mGraphicsWindow);
-    glCheckError();
+    if (!offscreen)
+    {
+        ::glfwSwapBuffers(mGraphicsWindow);
+        glCheckError();
+    }
 
     // setup default render state
     static const RenderStates defaultRenderStates;
@@ -319,6 +389,22 @@ void GraphicsDevice::Deinit()
     ::glDeleteVertexArrays(1, &mGraphicsContext.mVaoHandle);
     glCheckError();
 
+    if (mCaps.mFeatures[eGraphicsFeature_TimerQuery])
+    {
+        ::glEndQuery(GL_TIME_ELAPSED);
+        glCheckError();
+
+        ::glDeleteQueries(CountOf(mFrameTimeQueries), mFrameTimeQueries);
+        glCheckError();
+        mFrameTimeQueriesCount = 0;
+    }
+
+    if (mOffscreenRenderTarget)
+    {
+        DestroyRenderTarget(mOffscreenRenderTarget);
+        mOffscreenRenderTarget = nullptr;
+    }
+
     if (mGraphicsWindow) // shutdown glfw system
     {
         ::glfwDestroyWindow(mGraphicsWindow);
@@ -412,6 +498,35 @@ GpuTexture2D* GraphicsDevice::CreateTexture2D(eTextureFormat textureFormat, int
     return texture;
 }
 
+GpuRenderTarget* GraphicsDevice::CreateRenderTarget()
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return nullptr;
+    }
+
+    GpuRenderTarget* renderTarget = new GpuRenderTarget(mGraphicsContext);
+    return renderTarget;
+}
+
+GpuRenderTarget* GraphicsDevice::CreateRenderTarget(int sizex, int sizey)
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return nullptr;
+    }
+
+    GpuRenderTarget* renderTarget = new GpuRenderTarget(mGraphicsContext);
+    if (!renderTarget->Setup(sizex, sizey))
+    {
+        DestroyRenderTarget(renderTarget);
+        return nullptr;
+    }
+    return renderTarget;
+}
+
 GpuTextureArray2D* GraphicsDevice::CreateTextureArray2D()
 {
     if (!IsDeviceInited())
@@ -518,11 +633,16 @@ void GraphicsDevice::BindVertexBuffer(GpuBuffer* sourceBuffer, const VertexForma
         mGraphicsContext.mCurrentBuffers[eBufferContent_Vertices] = sourceBuffer;
         ::glBindBuffer(bufferTargetGL, sourceBuffer ? sourceBuffer->mResourceHandle : 0);
         glCheckError();
+        ++mGraphicsContext.mFrameStats.mVertexBufferBinds;
+    }
+    else
+    {
+        ++mGraphicsContext.mFrameStats.mVertexBufferBindsSkipped;
     }
 
     if (sourceBuffer)
     {
-        SetupVertexAttributes(streamDefinition);
+        SetupVertexAttributes(sourceBuffer, streamDefinition);
     }
 }
 
@@ -540,8 +660,12 @@ void GraphicsDevice::BindIndexBuffer(GpuBuffer* sourceBuffer)
     }
     
     if (mGraphicsContext.mCurrentBuffers[eBufferContent_Indices] == sourceBuffer)
+    {
+        ++mGraphicsContext.mFrameStats.mIndexBufferBindsSkipped;
         return;
+    }
 
+    ++mGraphicsContext.mFrameStats.mIndexBufferBinds;
     mGraphicsContext.mCurrentBuffers[eBufferContent_Indices] = sourceBuffer;
     GLenum bufferTargetGL = EnumToGL(eBufferContent_Indices);
     ::glBindBuffer(bufferTargetGL, sourceBuffer ? sourceBuffer->mResourceHandle : 0);
@@ -558,8 +682,12 @@ void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuBufferTexture* tex
 
     debug_assert(textureUnit < eTextureUnit_COUNT);
     if (mGraphicsContext.mCurrentTextures[textureUnit].mBufferTexture == texture)
+    {
+        ++mGraphicsContext.mFrameStats.mTextureBindsSkipped;
         return;
+    }
 
+    ++mGraphicsContext.mFrameStats.mTextureBinds;
     ActivateTextureUnit(textureUnit);
 
     mGraphicsContext.mCurrentTextures[textureUnit].mBufferTexture = texture;
@@ -577,8 +705,12 @@ void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuTexture2D* texture
 
     debug_assert(textureUnit < eTextureUnit_COUNT);
     if (mGraphicsContext.mCurrentTextures[textureUnit].mTexture2D == texture)
+    {
+        ++mGraphicsContext.mFrameStats.mTextureBindsSkipped;
         return;
+    }
 
+    ++mGraphicsContext.mFrameStats.mTextureBinds;
     ActivateTextureUnit(textureUnit);
 
     mGraphicsContext.mCurrentTextures[textureUnit].mTexture2D = texture;
@@ -596,8 +728,12 @@ void GraphicsDevice::BindTexture(eTextureUnit textureUnit, GpuTextureArray2D* te
 
     debug_assert(textureUnit < eTextureUnit_COUNT);
     if (mGraphicsContext.mCurrentTextures[textureUnit].mTextureArray2D == texture)
+    {
+        ++mGraphicsContext.mFrameStats.mTextureBindsSkipped;
         return;
+    }
 
+    ++mGraphicsContext.mFrameStats.mTextureBinds;
     ActivateTextureUnit(textureUnit);
 
     mGraphicsContext.mCurrentTextures[textureUnit].mTextureArray2D = texture;
@@ -614,13 +750,18 @@ void GraphicsDevice::BindRenderProgram(GpuProgram* program)
     }
 
     if (mGraphicsContext.mCurrentProgram == program)
+    {
+        ++mGraphicsContext.mFrameStats.mProgramBindsSkipped;
         return;
+    }
 
+    ++mGraphicsContext.mFrameStats.mProgramBinds;
     ::glUseProgram(program ? program->mResourceHandle : 0);
     glCheckError();
+
+    bool programAttributes[eVertexAttribute_MAX] = {};
     if (program)
     {
-        bool programAttributes[eVertexAttribute_MAX] = {};
         for (int streamIndex = 0; streamIndex < eVertexAttribute_MAX; ++streamIndex)
         {
             if (program->mAttributes[streamIndex] == GpuVariableNULL)
@@ -628,31 +769,16 @@ void GraphicsDevice::BindRenderProgram(GpuProgram* program)
 
             programAttributes[program->mAttributes[streamIndex]] = true;
         }
-
-        // setup attribute streams
-        for (int ivattribute = 0; ivattribute < eVertexAttribute_COUNT; ++ivattribute)
-        {
-            if (programAttributes[ivattribute])
-            {
-                ::glEnableVertexAttribArray(ivattribute);
-                glCheckError();
-            }
-            else
-            {
-                ::glDisableVertexAttribArray(ivattribute);
-                glCheckError();
-            }
-        }
     }
-    else
+
+    // setup attribute streams, only changed ones
+    for (int ivattribute = 0; ivattribute < eVertexAttribute_MAX; ++ivattribute)
     {
-        for (int ivattribute = 0; ivattribute < eVertexAttribute_MAX; ++ivattribute)
-        {
-            ::glDisableVertexAttribArray(ivattribute);
-            glCheckError();
-        }
+        EnableVertexAttribute(ivattribute, programAttributes[ivattribute]);
     }
     mGraphicsContext.mCurrentProgram = program;
+    // attribute locations may differ between programs
+    mGraphicsContext.mVertexFormatBuffer = nullptr;
 }
 
 void GraphicsDevice::DestroyTexture(GpuBufferTexture* textureResource)
@@ -688,6 +814,70 @@ void GraphicsDevice::DestroyTexture(GpuTextureArray2D* textureResource)
     SafeDelete(textureResource); 
 }
 
+void GraphicsDevice::DestroyRenderTarget(GpuRenderTarget* renderTarget)
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return;
+    }
+
+    SafeDelete(renderTarget);
+}
+
+void GraphicsDevice::BindRenderTarget(GpuRenderTarget* renderTarget)
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return;
+    }
+
+    if (renderTarget == nullptr)
+    {
+        renderTarget = mOffscreenRenderTarget;
+    }
+
+    if (renderTarget == mGraphicsContext.mCurrentRenderTarget)
+        return;
+
+    ::glBindFramebuffer(GL_FRAMEBUFFER, renderTarget ? renderTarget->mResourceHandle : 0);
+    glCheckError();
+
+    mGraphicsContext.mCurrentRenderTarget = renderTarget;
+}
+
+void GraphicsDevice::BlitRenderTarget(GpuRenderTarget* sourceTarget, const Rect2D& sourceRectangle, const Rect2D& destinationRectangle)
+{
+    if (!IsDeviceInited() || sourceTarget == nullptr)
+    {
+        debug_assert(false);
+        return;
+    }
+
+    debug_assert(sourceTarget != mGraphicsContext.mCurrentRenderTarget);
+
+    // blit is affected by scissor test
+    Rect2D prevScissorBox = mScissorBox;
+    SetScissorRect(destinationRectangle);
+
+    ::glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceTarget->mResourceHandle);
+    glCheckError();
+
+    ::glBlitFramebuffer(
+        sourceRectangle.x, sourceRectangle.y, sourceRectangle.x + sourceRectangle.w, sourceRectangle.y + sourceRectangle.h,
+        destinationRectangle.x, destinationRectangle.y, destinationRectangle.x + destinationRectangle.w, destinationRectangle.y + destinationRectangle.h,
+        GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glCheckError();
+    ++mGraphicsContext.mFrameStats.mDrawCalls;
+
+    GpuRenderTarget* currentRenderTarget = mGraphicsContext.mCurrentRenderTarget;
+    ::glBindFramebuffer(GL_READ_FRAMEBUFFER, currentRenderTarget ? currentRenderTarget->mResourceHandle : 0);
+    glCheckError();
+
+    SetScissorRect(prevScissorBox);
+}
+
 void GraphicsDevice::DestroyProgram(GpuProgram* programResource)
 {
     if (!IsDeviceInited())
@@ -726,6 +916,8 @@ void GraphicsDevice::RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesT
     GLenum indicesTypeGL = EnumToGL(indices);
     ::glDrawElements(primitives, numIndices, indicesTypeGL, BUFFER_OFFSET(offset));
     glCheckError();
+    ++mGraphicsContext.mFrameStats.mDrawCalls;
+    mGraphicsContext.mFrameStats.mPrimitivesCount += GetPrimitivesCount(primitive, numIndices);
 }
 
 void GraphicsDevice::RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesType indices, unsigned int offset, unsigned int numIndices, unsigned int baseVertex)
@@ -744,6 +936,8 @@ void GraphicsDevice::RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesT
     GLenum indicesTypeGL = EnumToGL(indices);
     ::glDrawElementsBaseVertex(primitives, numIndices, indicesTypeGL, BUFFER_OFFSET(offset), baseVertex);
     glCheckError();
+    ++mGraphicsContext.mFrameStats.mDrawCalls;
+    mGraphicsContext.mFrameStats.mPrimitivesCount += GetPrimitivesCount(primitive, numIndices);
 }
 
 void GraphicsDevice::RenderPrimitives(ePrimitiveType primitiveType, unsigned int firstIndex, unsigned int numElements)
@@ -760,6 +954,8 @@ void GraphicsDevice::RenderPrimitives(ePrimitiveType primitiveType, unsigned int
     GLenum primitives = EnumToGL(primitiveType);
     ::glDrawArrays(primitives, firstIndex, numElements);
     glCheckError();
+    ++mGraphicsContext.mFrameStats.mDrawCalls;
+    mGraphicsContext.mFrameStats.mPrimitivesCount += GetPrimitivesCount(primitiveType, numElements);
 }
 
 void GraphicsDevice::Present()
@@ -770,7 +966,19 @@ void GraphicsDevice::Present()
         return;
     }
 
-    ::glfwSwapBuffers(mGraphicsWindow);
+    if (!IsOffscreen())
+    {
+        ::glfwSwapBuffers(mGraphicsWindow);
+    }
+
+    mFrameStats = mGraphicsContext.mFrameStats;
+    mGraphicsContext.mFrameStats = GraphicsDeviceStats();
+
+    if (mCaps.mFeatures[eGraphicsFeature_TimerQuery])
+    {
+        ProcessFrameTimeQueries();
+    }
+
     // process window messages
     ::glfwPollEvents();
     if (::glfwWindowShouldClose(mGraphicsWindow) == GL_TRUE)
@@ -781,6 +989,30 @@ void GraphicsDevice::Present()
     ProcessGamepadsInputs();
 }
 
+void GraphicsDevice::ProcessFrameTimeQueries()
+{
+    ::glEndQuery(GL_TIME_ELAPSED);
+    glCheckError();
+
+    const int NumQueries = CountOf(mFrameTimeQueries);
+    mFrameTimeQueriesCount = std::min(mFrameTimeQueriesCount + 1, NumQueries);
+    mFrameTimeQueryIndex = (mFrameTimeQueryIndex + 1) % NumQueries;
+
+    // oldest query gets reused, read its result first, driver usually has it ready by this time so it should not stall
+    if (mFrameTimeQueriesCount == NumQueries)
+    {
+        GLuint64 elapsedTimeNs = 0;
+        ::glGetQueryObjectui64v(mFrameTimeQueries[mFrameTimeQueryIndex], GL_QUERY_RESULT, &elapsedTimeNs);
+        glCheckError();
+
+        mGpuFrameTimeMs = static_cast<float>(elapsedTimeNs / 1000000.0);
+        --mFrameTimeQueriesCount;
+    }
+
+    ::glBeginQuery(GL_TIME_ELAPSED, mFrameTimeQueries[mFrameTimeQueryIndex]);
+    glCheckError();
+}
+
 void GraphicsDevice::ProcessGamepadsInputs()
 {
     GLFWgamepadstate gamepadstate;
@@ -887,6 +1119,54 @@ bool GraphicsDevice::IsDeviceInited() const
     return mGraphicsWindow != nullptr;
 }
 
+bool GraphicsDevice::IsOffscreen() const
+{
+    return mOffscreenRenderTarget != nullptr;
+}
+
+bool GraphicsDevice::ReadFramebufferPixels(PixelsArray& outputPixels)
+{
+    if (!IsDeviceInited())
+    {
+        debug_assert(false);
+        return false;
+    }
+
+    const int sizex = mViewportRect.w;
+    const int sizey = mViewportRect.h;
+    if (outputPixels.mFormat != eTextureFormat_RGBA8 || outputPixels.mSizex != sizex || outputPixels.mSizey != sizey)
+    {
+        if (!outputPixels.Create(eTextureFormat_RGBA8, sizex, sizey))
+            return false;
+    }
+
+    // read from back buffer in windowed mode
+    if (!IsOffscreen())
+    {
+        ::glReadBuffer(GL_BACK);
+        glCheckError();
+    }
+
+    ::glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glCheckError();
+
+    ::glReadPixels(0, 0, sizex, sizey, GL_RGBA, GL_UNSIGNED_BYTE, outputPixels.mData);
+    glCheckError();
+
+    // opengl origin is bottom left corner, flip rows
+    const int rowLength = sizex * 4;
+    std::vector<unsigned char> tempRow(rowLength);
+    for (int iy = 0; iy < sizey / 2; ++iy)
+    {
+        unsigned char* rowTop = outputPixels.mData + iy * rowLength;
+        unsigned char* rowBottom = outputPixels.mData + (sizey - iy - 1) * rowLength;
+        ::memcpy(tempRow.data(), rowTop, rowLength);
+        ::memcpy(rowTop, rowBottom, rowLength);
+        ::memcpy(rowBottom, tempRow.data(), rowLength);
+    }
+    return true;
+}
+
 bool GraphicsDevice::InitializeOGLExtensions()
 {
     // initialize opengl extensions
@@ -930,8 +1210,22 @@ bool GraphicsDevice::InitializeOGLExtensions()
     return true;
 }
 
-void GraphicsDevice::SetupVertexAttributes(const VertexFormat& streamDefinition)
+void GraphicsDevice::SetupVertexAttributes(GpuBuffer* sourceBuffer, const VertexFormat& streamDefinition)
 {
+    // attribute pointers are still valid if nothing is changed since last setup
+    if (mGraphicsContext.mVertexFormatBuffer == sourceBuffer && 
+        mGraphicsContext.mVertexFormatBufferHandle == sourceBuffer->mResourceHandle &&
+        mGraphicsContext.mVertexFormat == streamDefinition)
+    {
+        ++mGraphicsContext.mFrameStats.mVertexFormatChangesSkipped;
+        return;
+    }
+
+    ++mGraphicsContext.mFrameStats.mVertexFormatChanges;
+    mGraphicsContext.mVertexFormatBuffer = sourceBuffer;
+    mGraphicsContext.mVertexFormatBufferHandle = sourceBuffer->mResourceHandle;
+    mGraphicsContext.mVertexFormat = streamDefinition;
+
     GpuProgram* currentProgram = mGraphicsContext.mCurrentProgram;
     for (int iattribute = 0; iattribute < eVertexAttribute_COUNT; ++iattribute)
     {
@@ -968,10 +1262,33 @@ void GraphicsDevice::SetupVertexAttributes(const VertexFormat& streamDefinition)
     }
 }
 
+void GraphicsDevice::EnableVertexAttribute(int attributeIndex, bool isEnabled)
+{
+    debug_assert(attributeIndex < eVertexAttribute_MAX);
+    if (mGraphicsContext.mEnabledAttributes[attributeIndex] == isEnabled)
+        return;
+
+    if (isEnabled)
+    {
+        ::glEnableVertexAttribArray(attributeIndex);
+    }
+    else
+    {
+        ::glDisableVertexAttribArray(attributeIndex);
+    }
+    glCheckError();
+    mGraphicsContext.mEnabledAttributes[attributeIndex] = isEnabled;
+}
+
 void GraphicsDevice::InternalSetRenderStates(const RenderStates& renderStates, bool forceState)
 {
     if (mCurrentStates == renderStates && !forceState)
+    {
+        ++mGraphicsContext.mFrameStats.mRenderStatesChangesSkipped;
         return;
+    }
+
+    ++mGraphicsContext.mFrameStats.mRenderStatesChanges;
 
     // polygon mode
     if (forceState || (mCurrentStates.mFillMode != renderStates.mFillMode))
@@ -1124,6 +1441,28 @@ void GraphicsDevice::QueryGraphicsDeviceCaps()
 {
     mCaps.mFeatures[eGraphicsFeature_NPOT_Textures] = (GLEW_ARB_texture_non_power_of_two == GL_TRUE);
     mCaps.mFeatures[eGraphicsFeature_ABGR] = (GLEW_EXT_abgr == GL_TRUE);
+    mCaps.mFeatures[eGraphicsFeature_TimerQuery] = (GLEW_ARB_timer_query == GL_TRUE);
+
+    // program binaries are supported only if driver provides at least one binary format
+    GLint numProgramBinaryFormats = 0;
+    if (GLEW_ARB_get_program_binary == GL_TRUE)
+    {
+        ::glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numProgramBinaryFormats);
+        glCheckError();
+    }
+    mCaps.mFeatures[eGraphicsFeature_ProgramBinary] = (numProgramBinaryFormats > 0);
+
+    mCaps.mDriverString.clear();
+    for (GLenum currString: { GL_VENDOR, GL_RENDERER, GL_VERSION })
+    {
+        const GLubyte* stringGL = ::glGetString(currString);
+        glCheckError();
+        if (stringGL)
+        {
+            mCaps.mDriverString.append(reinterpret_cast<const char*>(stringGL));
+        }
+        mCaps.mDriverString.append(";");
+    }
 
     ::glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &mCaps.mMaxTextureBufferSize);
     glCheckError();
@@ -1134,6 +1473,8 @@ void GraphicsDevice::QueryGraphicsDeviceCaps()
     gConsole.LogMessage(eLogMessage_Info, "Graphics Device caps:");
     gConsole.LogMessage(eLogMessage_Info, " - max array texture layers: %d", mCaps.mMaxArrayTextureLayers);
     gConsole.LogMessage(eLogMessage_Info, " - max texture buffer size: %d bytes", mCaps.mMaxTextureBufferSize);
+    gConsole.LogMessage(eLogMessage_Info, " - program binary formats: %d", numProgramBinaryFormats);
+    gConsole.LogMessage(eLogMessage_Info, " - driver: %s", mCaps.mDriverString.c_str());
 }
 
 void GraphicsDevice::ActivateTextureUnit(eTextureUnit textureUnit)
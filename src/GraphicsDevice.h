@@ -13,6 +13,8 @@ public:
     Rect2D mViewportRect;
     Rect2D mScissorBox;
     GraphicsDeviceCaps mCaps;
+    GraphicsDeviceStats mFrameStats; // stats of last presented frame
+    float mGpuFrameTimeMs = 0.0f; // gpu time of frame presented few frames ago, zero if timer queries not supported
 
     // these params will automatically set during texture creation
     eTextureFilterMode mDefaultTextureFilter = eTextureFilterMode_Nearest;
@@ -61,6 +63,11 @@ public:
     GpuTextureArray2D* CreateTextureArray2D();
     GpuTextureArray2D* CreateTextureArray2D(eTextureFormat textureFormat, int sizex, int sizey, int layersCount, const void* sourceData);
 
+    // Create offscreen render target with color and depth buffers, client is responsible for destroying resource
+    // @param sizex, sizey: Render target dimensions
+    GpuRenderTarget* CreateRenderTarget();
+    GpuRenderTarget* CreateRenderTarget(int sizex, int sizey);
+
     // Create render program, client is responsible for destroying resource
     // @param shaderSource: Source code
     GpuProgram* CreateRenderProgram();
@@ -95,12 +102,26 @@ public:
     // @param program: Target program
     void BindRenderProgram(GpuProgram* program);
 
+    // Set render target for subsequent draw operations
+    // @param renderTarget: Target or nullptr to draw into default framebuffer
+    void BindRenderTarget(GpuRenderTarget* renderTarget);
+
+    // Copy color buffer region of render target into current framebuffer with linear filtering
+    // @param sourceTarget: Source render target, must not be bound
+    // @param sourceRectangle: Source region
+    // @param destinationRectangle: Destination region, can be of different size
+    void BlitRenderTarget(GpuRenderTarget* sourceTarget, const Rect2D& sourceRectangle, const Rect2D& destinationRectangle);
+
     // Free hardware resource
     // @param textureResource: Target texture, pointer becomes invalid
     void DestroyTexture(GpuBufferTexture* textureResource);
     void DestroyTexture(GpuTexture2D* textureResource);
     void DestroyTexture(GpuTextureArray2D* textureResource);
 
+    // Free hardware resource
+    // @param renderTarget: Target render target, pointer becomes invalid
+    void DestroyRenderTarget(GpuRenderTarget* renderTarget);
+
     // Free hardware resource
     // @param programResource: Target render program, pointer becomes invalid
     void DestroyProgram(GpuProgram* programResource);
@@ -149,8 +170,15 @@ public:
     // Clear color and depth of current framebuffer
     void ClearScreen();
 
+    // Read back color pixels of current framebuffer, should be called before Present
+    // @param outputPixels: Output RGBA8 bitmap, top row goes first
+    bool ReadFramebufferPixels(PixelsArray& outputPixels);
+
     // Test whether graphics is initialized properly
-    bool IsDeviceInited() const;
+    bool IsDeviceInited() const;
+
+    // Test whether frames are rendered to offscreen framebuffer instead of window
+    bool IsOffscreen() const;
     
 private:
     // Force render state
@@ -160,14 +188,22 @@ private:
     void QueryGraphicsDeviceCaps();
     void ActivateTextureUnit(eTextureUnit textureUnit);
 
-    void SetupVertexAttributes(const VertexFormat& streamDefinition);
+    void SetupVertexAttributes(GpuBuffer* sourceBuffer, const VertexFormat& streamDefinition);
+    void EnableVertexAttribute(int attributeIndex, bool isEnabled);
 
     void ProcessGamepadsInputs();
 
+    void ProcessFrameTimeQueries();
+
 private:
     GraphicsContext mGraphicsContext;
     GLFWwindow* mGraphicsWindow;
     GLFWmonitor* mGraphicsMonitor;
+    GpuRenderTarget* mOffscreenRenderTarget = nullptr; // default framebuffer in offscreen mode
+    // gpu frame timings
+    GpuQueryHandle mFrameTimeQueries[3];
+    int mFrameTimeQueryIndex = 0; // current frame query
+    int mFrameTimeQueriesCount = 0; // queries in flight
 };
 
 extern GraphicsDevice gGraphicsDevice;
\ No newline at end of file
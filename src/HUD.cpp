@@ -5,10 +5,11 @@
 #include "Pedestrian.h"
 #include "SpriteManager.h"
 #include "GameMapManager.h"
+#include "GameObjectsManager.h"
 
 void HUD::Setup(Pedestrian* character)
 {
-    mCharacter = character;
+    mCharacter = character ? character->GetHandle() : GameObjectHandle();
 }
 
 void HUD::UpdateFrame(Timespan deltaTile)
@@ -18,14 +19,15 @@ void HUD::UpdateFrame(Timespan deltaTile)
 
 void HUD::DrawFrame(UiContext& uiContext)
 {
-    if (mCharacter == nullptr)
+    Pedestrian* character = gGameObjectsManager.GetPedestrianByHandle(mCharacter);
+    if (character == nullptr)
         return;
 
     // temporary
-    if (mCharacter->mCurrentWeapon != eWeaponType_Fists)
+    if (character->mCurrentWeapon != eWeaponType_Fists)
     {
         int arrowSpriteIndex = 30;
-        switch (mCharacter->mCurrentWeapon)
+        switch (character->mCurrentWeapon)
         {
             case eWeaponType_Pistol: arrowSpriteIndex = 30; break;
             case eWeaponType_Machinegun: arrowSpriteIndex = 31; break;
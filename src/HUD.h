@@ -13,5 +13,5 @@ public:
     void DrawFrame(UiContext& uiContext);
 
 private:
-    Pedestrian* mCharacter = nullptr;
+    GameObjectHandle mCharacter;
 };
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "Vehicle.h"
 #include "GameMapManager.h"
 #include "CarnageGame.h"
+#include "WorldSnapshot.h"
 
 static const Timespan PlayerCharacterRespawnTime = Timespan::FromSeconds(10.0f);
 
@@ -347,7 +348,7 @@ void HumanCharacterController::EnterOrExitCar(bool alternative)
     gPhysics.QueryObjectsLinecast(posA, posB, linecastResult);
 
     // process all cars
-    for (int icar = 0; icar < linecastResult.mHitsCount; ++icar)
+    for (int icar = 0; icar < linecastResult.mHits.GetCount(); ++icar)
     {
         CarPhysicsComponent* carBody = linecastResult.mHits[icar].mCarComponent;
         if (carBody == nullptr)
@@ -381,3 +382,14 @@ void HumanCharacterController::Respawn()
 
     mCharacter->Spawn(mSpawnPosition, mCharacter->mPhysicsComponent->GetRotationAngle());
 }
+
+void HumanCharacterController::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    snapshot.Write(mSpawnPosition);
+    snapshot.Write(mRespawnTime);
+}
+
+bool HumanCharacterController::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    return snapshot.Read(mSpawnPosition) && snapshot.Read(mRespawnTime);
+}
@@ -58,6 +58,11 @@ public:
     void InputEvent(KeyInputEvent& inputEvent);
     void InputEvent(GamepadInputEvent& inputEvent);
 
+    // write or read controller state, used by world snapshots
+    // @param snapshot: Snapshot data
+    void SaveSnapshot(WorldSnapshot& snapshot) const;
+    bool LoadSnapshot(WorldSnapshot& snapshot);
+
 private:
     bool HandleInputAction(ePedestrianAction action, bool isActivated);
     void SwitchNextWeapon();
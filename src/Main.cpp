@@ -28,6 +28,55 @@ int main(int argc, char *argv[])
             iarg += 2;
             continue;
         }
+        if (cxx_stricmp(argv[iarg], "-benchmark") == 0 && (argc > iarg + 1))
+        {
+            ::sscanf(argv[iarg + 1], "%d", &sysStartupParams.mBenchmarkFrames);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-capture") == 0 && (argc > iarg + 1))
+        {
+            sysStartupParams.mFrameCaptureScript.set_content(argv[iarg + 1]);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-benchmarkcars") == 0 && (argc > iarg + 1))
+        {
+            ::sscanf(argv[iarg + 1], "%d", &sysStartupParams.mBenchmarkCars);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-benchmarkpeds") == 0 && (argc > iarg + 1))
+        {
+            ::sscanf(argv[iarg + 1], "%d", &sysStartupParams.mBenchmarkPedestrians);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-physicsthreads") == 0 && (argc > iarg + 1))
+        {
+            ::sscanf(argv[iarg + 1], "%d", &sysStartupParams.mPhysicsThreadsCount);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-statehash") == 0 && (argc > iarg + 1))
+        {
+            sysStartupParams.mStateHashLog.set_content(argv[iarg + 1]);
+            iarg += 2;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-statehashdiff") == 0 && (argc > iarg + 2))
+        {
+            sysStartupParams.mStateHashCompare[0].set_content(argv[iarg + 1]);
+            sysStartupParams.mStateHashCompare[1].set_content(argv[iarg + 2]);
+            iarg += 3;
+            continue;
+        }
+        if (cxx_stricmp(argv[iarg], "-offscreen") == 0)
+        {
+            sysStartupParams.mOffscreen = true;
+            iarg += 1;
+            continue;
+        }
         ++iarg;
     }
 
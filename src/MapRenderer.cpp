@@ -14,15 +14,57 @@
 
 //////////////////////////////////////////////////////////////////////////
 
+// get bits of x and y coordinates from interleaved morton code
+inline void MortonDecode2D(unsigned int mortonCode, int& coordx, int& coordy)
+{
+    coordx = 0;
+    coordy = 0;
+    for (int ibit = 0; ibit < 16; ++ibit)
+    {
+        coordx |= ((mortonCode >> (ibit * 2 + 0)) & 1) << ibit;
+        coordy |= ((mortonCode >> (ibit * 2 + 1)) & 1) << ibit;
+    }
+}
+
+// get linear index of quadtree node which are stored level by level
+inline int GetQuadtreeNodeIndex(int treeLevel, unsigned int nodeCode)
+{
+    int levelStartIndex = ((1 << (treeLevel * 2)) - 1) / 3;
+    return levelStartIndex + nodeCode;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 void MapRenderStats::FrameBegin()
 {
     mBlockChunksDrawnCount = 0;
+    mCityMeshDrawCallsCount = 0;
+    mCityMeshTrianglesCount = 0;
+    mLayerBandsOccludedCount = 0;
+    mCityMeshCullingTimeMs = 0.0f;
+    mObjectsExtractedCount = 0;
+    mObjectsCulledCount = 0;
+    mSpritesDrawnCount = 0;
+    mExtractionTimeMs = 0.0f;
+    mRenderCommandsCount = 0;
+    mRecordingTimeMs = 0.0f;
 }
 
 void MapRenderStats::FrameEnd()
 {
 }
 
+void MapRenderStats::AddViewStats(const MapRenderStats& viewStats)
+{
+    mBlockChunksDrawnCount += viewStats.mBlockChunksDrawnCount;
+    mCityMeshDrawCallsCount += viewStats.mCityMeshDrawCallsCount;
+    mCityMeshTrianglesCount += viewStats.mCityMeshTrianglesCount;
+    mLayerBandsOccludedCount += viewStats.mLayerBandsOccludedCount;
+    mCityMeshCullingTimeMs += viewStats.mCityMeshCullingTimeMs;
+    mSpritesDrawnCount += viewStats.mSpritesDrawnCount;
+    mRenderCommandsCount += viewStats.mRenderCommandsCount;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 bool MapRenderer::Initialize()
@@ -36,18 +78,38 @@ bool MapRenderer::Initialize()
     if (mCityMeshBufferV == nullptr || mCityMeshBufferI == nullptr)
         return false;
 
-    if (!mSpriteBatch.Initialize())
+    if (!mExtractedSprites.Initialize())
     {
         gConsole.LogMessage(eLogMessage_Warning, "Cannot initialize sprites batch");
         return false;
     }
 
+    for (ViewRenderContext& currViewContext: mViewContexts)
+    {
+        if (!currViewContext.mSpriteBatch.Initialize())
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Cannot initialize sprites batch");
+            return false;
+        }
+    }
+
+    mViewWorkers.Initialize(GAME_MAX_PLAYERS);
     return true;
 }
 
 void MapRenderer::Deinit()
 {
-    mSpriteBatch.Deinit();
+    mViewWorkers.Deinit();
+
+    for (ViewRenderContext& currViewContext: mViewContexts)
+    {
+        currViewContext.mSpriteBatch.Deinit();
+        currViewContext.mCommandBuffer.Clear();
+        currViewContext.mDrawRanges.clear();
+    }
+    mRecordedViewsCount = 0;
+    mExtractedSprites.Deinit();
+    mExtractedSpritesBounds.clear();
     if (mCityMeshBufferV)
     {
         gGraphicsDevice.DestroyBuffer(mCityMeshBufferV);
@@ -71,38 +133,151 @@ void MapRenderer::RenderFrameEnd()
     mRenderStats.FrameEnd();
 }
 
-void MapRenderer::RenderFrame(RenderView* renderview)
-{
-    debug_assert(renderview);
-
-    gGraphicsDevice.BindTexture(eTextureUnit_3, gSpriteManager.mPalettesTable);
-    gGraphicsDevice.BindTexture(eTextureUnit_2, gSpriteManager.mPaletteIndicesTable);
-
-    DrawCityMesh(renderview);
-
-    mSpriteBatch.BeginBatch(SpriteBatch::DepthAxis_Y);
-
-    // collect and render game objects sprites - the order matters
-
+void MapRenderer::ExtractFrameObjects(const std::vector<RenderView*>& renderviews)
+{
+    double extractionStartTime = gSystem.GetSysSeconds();
+
+    mExtractedSprites.BeginBatch(SpriteBatch::DepthAxis_Y);
+
+    auto IsVisibleInAnyView = [&renderviews](const cxx::aabbox_t& bounds)
+    {
+        for (const RenderView* currRenderview: renderviews)
+        {
+            if (currRenderview->mCamera.mFrustum.contains(bounds))
+                return true;
+        }
+        return false;
+    };
+
+    // collect game objects sprites - the order matters
+    // objects outside of all views are skipped before any draw work is done
+
+    cxx::aabbox_t objectBounds;
     for (Vehicle* currGameObject: gGameObjectsManager.mCarsList)
     {
-        currGameObject->DrawFrame(mSpriteBatch);
-    }
-
-    for (Pedestrian* currGameObject: gGameObjectsManager.mPedestriansList)
+        currGameObject->GetDrawBounds(objectBounds);
+        if (!IsVisibleInAnyView(objectBounds))
+        {
+            ++mRenderStats.mObjectsCulledCount;
+            continue;
+        }
+        currGameObject->DrawFrame(mExtractedSprites);
+        ++mRenderStats.mObjectsExtractedCount;
+    }
+
+    // pedestrians are culled using hot arrays, only visible ones are touched
+    const PedestriansHotData& pedsHotData = gGameObjectsManager.mPedestriansHotData;
+    for (int islot = 0, numSlots = pedsHotData.GetCount(); islot < numSlots; ++islot)
     {
-        currGameObject->DrawFrame(mSpriteBatch);
-    }
-
-    gRenderManager.mSpritesProgram.Activate();
-    gRenderManager.mSpritesProgram.UploadCameraTransformMatrices(renderview->mCamera);
-
-    RenderStates guiRenderStates = RenderStates().Disable(RenderStateFlags_FaceCulling);
-    gGraphicsDevice.SetRenderStates(guiRenderStates);
-
-    mSpriteBatch.Flush();
-
-    gRenderManager.mSpritesProgram.Deactivate();
+        if (pedsHotData.mPedestrians[islot] == nullptr)
+            continue;
+
+        pedsHotData.GetDrawBounds(islot, objectBounds);
+        if (!IsVisibleInAnyView(objectBounds))
+        {
+            ++mRenderStats.mObjectsCulledCount;
+            continue;
+        }
+        pedsHotData.mPedestrians[islot]->DrawFrame(mExtractedSprites);
+        ++mRenderStats.mObjectsExtractedCount;
+    }
+
+    // compute exact bounds of extracted sprites for per view culling
+    const std::vector<Sprite2D>& extractedSprites = mExtractedSprites.GetSprites();
+
+    mExtractedSpritesBounds.resize(extractedSprites.size());
+    for (int isprite = 0, NumSprites = extractedSprites.size(); isprite < NumSprites; ++isprite)
+    {
+        const Sprite2D& sprite = extractedSprites[isprite];
+
+        glm::vec2 corners[4];
+        sprite.GetCorners(corners);
+
+        cxx::aabbox_t& spriteBounds = mExtractedSpritesBounds[isprite];
+        spriteBounds.mMin = glm::vec3 { corners[0].x, sprite.mHeight, corners[0].y };
+        spriteBounds.mMax = spriteBounds.mMin;
+        for (int icorner = 1; icorner < 4; ++icorner)
+        {
+            spriteBounds.extend(corners[icorner].x, sprite.mHeight, corners[icorner].y);
+        }
+    }
+
+    mRenderStats.mExtractionTimeMs += static_cast<float>((gSystem.GetSysSeconds() - extractionStartTime) * 1000.0);
+}
+
+void MapRenderer::RecordRenderViews(const std::vector<RenderView*>& renderviews)
+{
+    double recordingStartTime = gSystem.GetSysSeconds();
+
+    mRecordedViewsCount = renderviews.size();
+    if (mRecordedViewsCount > GAME_MAX_PLAYERS)
+    {
+        debug_assert(false);
+        mRecordedViewsCount = GAME_MAX_PLAYERS;
+    }
+
+    // views are picked by current thread and persistent worker threads
+    mViewWorkers.RunChunks(mRecordedViewsCount, [this, &renderviews](int iview)
+        {
+            RecordRenderView(mViewContexts[iview], renderviews[iview]);
+        });
+
+    for (int iview = 0; iview < mRecordedViewsCount; ++iview)
+    {
+        mRenderStats.AddViewStats(mViewContexts[iview].mRenderStats);
+    }
+
+    mRenderStats.mRecordingTimeMs += static_cast<float>((gSystem.GetSysSeconds() - recordingStartTime) * 1000.0);
+}
+
+void MapRenderer::RecordRenderView(ViewRenderContext& viewContext, RenderView* renderview)
+{
+    debug_assert(renderview);
+
+    viewContext.mRenderStats.FrameBegin();
+
+    RenderCommandBuffer& commandBuffer = viewContext.mCommandBuffer;
+    commandBuffer.Clear();
+    commandBuffer.BindTexture(eTextureUnit_3, gSpriteManager.mPalettesTable);
+    commandBuffer.BindTexture(eTextureUnit_2, gSpriteManager.mPaletteIndicesTable);
+
+    RecordCityMesh(viewContext, renderview);
+
+    viewContext.mSpriteBatch.BeginBatch(SpriteBatch::DepthAxis_Y);
+
+    // pick extracted sprites visible in current view, keep extraction order
+    const cxx::frustum_t& cameraFrustum = renderview->mCamera.mFrustum;
+    const std::vector<Sprite2D>& extractedSprites = mExtractedSprites.GetSprites();
+    for (int isprite = 0, NumSprites = extractedSprites.size(); isprite < NumSprites; ++isprite)
+    {
+        if (!cameraFrustum.contains(mExtractedSpritesBounds[isprite]))
+            continue;
+
+        viewContext.mSpriteBatch.DrawSprite(extractedSprites[isprite]);
+        ++viewContext.mRenderStats.mSpritesDrawnCount;
+    }
+
+    commandBuffer.ActivateProgram(&gRenderManager.mSpritesProgram);
+    commandBuffer.UploadCameraTransformMatrices(&gRenderManager.mSpritesProgram, renderview->mCamera);
+
+    RenderStates guiRenderStates = RenderStates().Disable(RenderStateFlags_FaceCulling);
+    commandBuffer.SetRenderStates(guiRenderStates);
+
+    viewContext.mSpriteBatch.Flush(commandBuffer);
+
+    commandBuffer.DeactivateProgram(&gRenderManager.mSpritesProgram);
+
+    viewContext.mRenderStats.mRenderCommandsCount = commandBuffer.GetCommandsCount();
+}
+
+void MapRenderer::RenderFrame(int renderviewIndex)
+{
+    if (renderviewIndex < 0 || renderviewIndex >= mRecordedViewsCount)
+    {
+        debug_assert(false);
+        return;
+    }
+    mViewContexts[renderviewIndex].mCommandBuffer.Execute();
 }
 
 void MapRenderer::RenderDebug(RenderView* renderview, DebugRenderer& debugRender)
@@ -114,69 +289,112 @@ void MapRenderer::RenderDebug(RenderView* renderview, DebugRenderer& debugRender
     }
 }
 
-void MapRenderer::DrawCityMesh(RenderView* renderview)
+void MapRenderer::RecordCityMesh(ViewRenderContext& viewContext, RenderView* renderview)
 {
-    RenderStates cityMeshRenderStates;
-
-    gGraphicsDevice.SetRenderStates(cityMeshRenderStates);
-
-    gRenderManager.mCityMeshProgram.Activate();
-    gRenderManager.mCityMeshProgram.UploadCameraTransformMatrices(renderview->mCamera);
-
-    if (mCityMeshBufferV && mCityMeshBufferI)
-    {
-        gGraphicsDevice.BindVertexBuffer(mCityMeshBufferV, CityVertex3D_Format::Get());
-        gGraphicsDevice.BindIndexBuffer(mCityMeshBufferI);
-        gGraphicsDevice.BindTexture(eTextureUnit_0, gSpriteManager.mBlocksTextureArray);
-        gGraphicsDevice.BindTexture(eTextureUnit_1, gSpriteManager.mBlocksIndicesTable);
-
-        for (const MapBlocksChunk& currChunk: mMapBlocksChunks)
-        {
-            if (!renderview->mCamera.mFrustum.contains(currChunk.mBounds))
-                continue;
-
-            gGraphicsDevice.RenderIndexedPrimitives(ePrimitiveType_Triangles, eIndicesType_i32, 
-                currChunk.mIndicesStart * Sizeof_DrawIndex, currChunk.mIndicesCount);
-
-            ++mRenderStats.mBlockChunksDrawnCount;
-        }
-    }
-    gRenderManager.mCityMeshProgram.Deactivate();
+    RenderCommandBuffer& commandBuffer = viewContext.mCommandBuffer;
+
+    RenderStates cityMeshRenderStates;
+    commandBuffer.SetRenderStates(cityMeshRenderStates);
+
+    commandBuffer.ActivateProgram(&gRenderManager.mCityMeshProgram);
+    commandBuffer.UploadCameraTransformMatrices(&gRenderManager.mCityMeshProgram, renderview->mCamera);
+
+    if (mCityMeshBufferV && mCityMeshBufferI)
+    {
+        commandBuffer.BindVertexBuffer(mCityMeshBufferV, CityVertex3D_Format::Get());
+        commandBuffer.BindIndexBuffer(mCityMeshBufferI);
+        commandBuffer.BindTexture(eTextureUnit_0, gSpriteManager.mBlocksTextureArray);
+        commandBuffer.BindTexture(eTextureUnit_1, gSpriteManager.mBlocksIndicesTable);
+
+        double cullingStartTime = gSystem.GetSysSeconds();
+
+        // visible chunks are neighbours in morton order so they form contiguous ranges
+        viewContext.mDrawRanges.clear();
+        CullChunksTree(viewContext, renderview->mCamera, 0, 0);
+
+        viewContext.mRenderStats.mCityMeshCullingTimeMs += static_cast<float>((gSystem.GetSysSeconds() - cullingStartTime) * 1000.0);
+
+        for (const DrawIndicesRange& currRange: viewContext.mDrawRanges)
+        {
+            commandBuffer.RenderIndexedPrimitives(ePrimitiveType_Triangles, eIndicesType_i32, 
+                currRange.mIndicesStart * Sizeof_DrawIndex, currRange.mIndicesCount);
+
+            ++viewContext.mRenderStats.mCityMeshDrawCallsCount;
+            viewContext.mRenderStats.mCityMeshTrianglesCount += currRange.mIndicesCount / 3;
+        }
+    }
+    commandBuffer.DeactivateProgram(&gRenderManager.mCityMeshProgram);
 }
 
 void MapRenderer::BuildMapMesh()
 {
     MapMeshData blocksMesh;
-    for (int batchy = 0; batchy < BlocksBatchesPerSide; ++batchy)
+
+    // chunks are built in morton order, so neighbouring chunks have neighbouring geometry in buffers
+    for (unsigned int mortonCode = 0; mortonCode < ChunksTreeDims * ChunksTreeDims; ++mortonCode)
     {
-        for (int batchx = 0; batchx < BlocksBatchesPerSide; ++batchx)
+        int batchx;
+        int batchy;
+        MortonDecode2D(mortonCode, batchx, batchy);
+        if (batchx >= BlocksBatchesPerSide || batchy >= BlocksBatchesPerSide)
+            continue;
+
+        Rect2D mapArea { 
+            batchx * BlocksBatchDims - ExtraBlocksPerSide, 
+            batchy * BlocksBatchDims - ExtraBlocksPerSide,
+            BlocksBatchDims,
+            BlocksBatchDims };
+
+        unsigned int prevVerticesCount = blocksMesh.mBlocksVertices.size();
+        unsigned int prevIndicesCount = blocksMesh.mBlocksIndices.size();
+
+        MapBlocksChunk& currChunk = mMapBlocksChunks[batchy * BlocksBatchesPerSide + batchx];
+        currChunk.mBounds.mMin = glm::vec3 { mapArea.x * MAP_BLOCK_LENGTH, 0, mapArea.y * MAP_BLOCK_LENGTH };
+        currChunk.mBounds.mMax = glm::vec3 { 
+            (mapArea.x + mapArea.w) * MAP_BLOCK_LENGTH, MAP_LAYERS_COUNT * MAP_BLOCK_LENGTH, 
+            (mapArea.y + mapArea.h) * MAP_BLOCK_LENGTH };
+
+        currChunk.mVerticesStart = prevVerticesCount;
+        currChunk.mIndicesStart = prevIndicesCount;
+
+        // find out which layers has continuous lids over chunk area
+        Rect2D occludersArea {
+            mapArea.x - OccludersMarginBlocks,
+            mapArea.y - OccludersMarginBlocks,
+            mapArea.w + OccludersMarginBlocks * 2,
+            mapArea.h + OccludersMarginBlocks * 2 };
+
+        bool hasContinuousLids[MAP_LAYERS_COUNT];
+        for (int ilayer = 0; ilayer < MAP_LAYERS_COUNT; ++ilayer)
         {
-            Rect2D mapArea { 
-                batchx * BlocksBatchDims - ExtraBlocksPerSide, 
-                batchy * BlocksBatchDims - ExtraBlocksPerSide,
-                BlocksBatchDims,
-                BlocksBatchDims };
-
-            unsigned int prevVerticesCount = blocksMesh.mBlocksVertices.size();
-            unsigned int prevIndicesCount = blocksMesh.mBlocksIndices.size();
-
-            MapBlocksChunk& currChunk = mMapBlocksChunks[batchy * BlocksBatchesPerSide + batchx];
-            currChunk.mBounds.mMin = glm::vec3 { mapArea.x * MAP_BLOCK_LENGTH, 0, mapArea.y * MAP_BLOCK_LENGTH };
-            currChunk.mBounds.mMax = glm::vec3 { 
-                (mapArea.x + mapArea.w) * MAP_BLOCK_LENGTH, MAP_LAYERS_COUNT * MAP_BLOCK_LENGTH, 
-                (mapArea.y + mapArea.h) * MAP_BLOCK_LENGTH };
-
-            currChunk.mVerticesStart = prevVerticesCount;
-            currChunk.mIndicesStart = prevIndicesCount;
-            
-            // append new geometry
-            GameMapHelpers::BuildMapMesh(gGameMap, mapArea, blocksMesh);
-            
-            currChunk.mVerticesCount = blocksMesh.mBlocksVertices.size() - prevVerticesCount;
-            currChunk.mIndicesCount = blocksMesh.mBlocksIndices.size() - prevIndicesCount;
+            hasContinuousLids[ilayer] = HasContinuousLids(occludersArea, ilayer);
         }
+
+        // append new geometry layer by layer
+        for (int ilayer = 0; ilayer < MAP_LAYERS_COUNT; ++ilayer)
+        {
+            MapLayerBand& layerBand = currChunk.mLayerBands[ilayer];
+            layerBand.mIndicesStart = blocksMesh.mBlocksIndices.size();
+            GameMapHelpers::BuildMapMesh(gGameMap, mapArea, ilayer, blocksMesh);
+            layerBand.mIndicesCount = blocksMesh.mBlocksIndices.size() - layerBand.mIndicesStart;
+
+            layerBand.mOccluderLayer = -1;
+            for (int iupperLayer = ilayer + 1; iupperLayer < MAP_LAYERS_COUNT; ++iupperLayer)
+            {
+                if (hasContinuousLids[iupperLayer])
+                {
+                    layerBand.mOccluderLayer = iupperLayer;
+                    break;
+                }
+            }
+        }
+            
+        currChunk.mVerticesCount = blocksMesh.mBlocksVertices.size() - prevVerticesCount;
+        currChunk.mIndicesCount = blocksMesh.mBlocksIndices.size() - prevIndicesCount;
     }
 
+    BuildChunksTree();
+
     // upload map geometry to video memory
     int totalVertexDataBytes = blocksMesh.mBlocksVertices.size() * Sizeof_CityVertex3D;
     int totalIndexDataBytes = blocksMesh.mBlocksIndices.size() * Sizeof_DrawIndex;
@@ -196,4 +414,172 @@ void MapRenderer::BuildMapMesh()
         memcpy(pdata, blocksMesh.mBlocksIndices.data(), totalIndexDataBytes);
         mCityMeshBufferI->Unlock();
     }
+}
+
+void MapRenderer::BuildChunksTree()
+{
+    const int leafLevel = ChunksTreeLevels - 1;
+
+    // setup leaf nodes, those outside of chunks grid are left empty
+    unsigned int currentIndicesStart = 0;
+    for (unsigned int mortonCode = 0; mortonCode < ChunksTreeDims * ChunksTreeDims; ++mortonCode)
+    {
+        ChunksTreeNode& leafNode = mChunksTree[GetQuadtreeNodeIndex(leafLevel, mortonCode)];
+        leafNode = ChunksTreeNode();
+        leafNode.mIndicesStart = currentIndicesStart;
+
+        int batchx;
+        int batchy;
+        MortonDecode2D(mortonCode, batchx, batchy);
+        if (batchx >= BlocksBatchesPerSide || batchy >= BlocksBatchesPerSide)
+            continue;
+
+        int chunkIndex = batchy * BlocksBatchesPerSide + batchx;
+        const MapBlocksChunk& currChunk = mMapBlocksChunks[chunkIndex];
+        debug_assert(currChunk.mIndicesStart == currentIndicesStart);
+        if (currChunk.mIndicesCount > 0)
+        {
+            leafNode.mBounds = currChunk.mBounds;
+            leafNode.mIndicesCount = currChunk.mIndicesCount;
+            leafNode.mChunksCount = 1;
+            leafNode.mChunkIndex = chunkIndex;
+        }
+        currentIndicesStart += currChunk.mIndicesCount;
+    }
+
+    // setup inner nodes bottom to top, each node range spans over its children ranges
+    for (int treeLevel = leafLevel - 1; treeLevel >= 0; --treeLevel)
+    {
+        for (unsigned int nodeCode = 0, NumNodes = (1 << (treeLevel * 2)); nodeCode < NumNodes; ++nodeCode)
+        {
+            ChunksTreeNode& currNode = mChunksTree[GetQuadtreeNodeIndex(treeLevel, nodeCode)];
+            currNode = ChunksTreeNode();
+            currNode.mIndicesStart = mChunksTree[GetQuadtreeNodeIndex(treeLevel + 1, nodeCode * 4)].mIndicesStart;
+
+            for (unsigned int ichild = 0; ichild < 4; ++ichild)
+            {
+                const ChunksTreeNode& childNode = mChunksTree[GetQuadtreeNodeIndex(treeLevel + 1, nodeCode * 4 + ichild)];
+                if (childNode.mChunksCount == 0)
+                    continue;
+
+                if (currNode.mChunksCount == 0)
+                {
+                    currNode.mBounds = childNode.mBounds;
+                }
+                else
+                {
+                    currNode.mBounds.extend(childNode.mBounds);
+                }
+                currNode.mIndicesCount += childNode.mIndicesCount;
+                currNode.mChunksCount += childNode.mChunksCount;
+            }
+        }
+    }
+}
+
+void MapRenderer::CullChunksTree(ViewRenderContext& viewContext, const GameCamera& camera, int treeLevel, unsigned int nodeCode)
+{
+    const ChunksTreeNode& currNode = mChunksTree[GetQuadtreeNodeIndex(treeLevel, nodeCode)];
+    if (currNode.mChunksCount == 0)
+        return;
+
+    int cullResult = camera.mFrustum.classify(currNode.mBounds);
+    if (cullResult == cxx::FRUSTUM_OUTSIDE)
+        return;
+
+    const int leafLevel = ChunksTreeLevels - 1;
+    if (treeLevel < leafLevel && cullResult != cxx::FRUSTUM_INSIDE)
+    {
+        // children are visited in morton order
+        for (unsigned int ichild = 0; ichild < 4; ++ichild)
+        {
+            CullChunksTree(viewContext, camera, treeLevel + 1, nodeCode * 4 + ichild);
+        }
+        return;
+    }
+
+    // node is visible as a whole, its chunks are emitted without further frustum tests
+    viewContext.mRenderStats.mBlockChunksDrawnCount += currNode.mChunksCount;
+
+    // layer bands are never occluded in ortho mode, so whole node range goes at once
+    if (camera.mCurrentMode != eSceneCameraMode_Perspective)
+    {
+        AddDrawRange(viewContext, currNode.mIndicesStart, currNode.mIndicesCount);
+        return;
+    }
+
+    // leaf nodes under current node are contiguous in morton order
+    unsigned int leavesCount = 1 << ((leafLevel - treeLevel) * 2);
+    for (unsigned int leafCode = nodeCode * leavesCount, leafCodeEnd = leafCode + leavesCount; leafCode < leafCodeEnd; ++leafCode)
+    {
+        const ChunksTreeNode& leafNode = mChunksTree[GetQuadtreeNodeIndex(leafLevel, leafCode)];
+        if (leafNode.mChunksCount == 0)
+            continue;
+
+        AddChunkDrawRanges(viewContext, camera, mMapBlocksChunks[leafNode.mChunkIndex]);
+    }
+}
+
+void MapRenderer::AddChunkDrawRanges(ViewRenderContext& viewContext, const GameCamera& camera, const MapBlocksChunk& chunk)
+{
+    // distance from camera to farthest point of chunk, horizontally
+    float farthestx = glm::max(glm::abs(camera.mPosition.x - chunk.mBounds.mMin.x), glm::abs(camera.mPosition.x - chunk.mBounds.mMax.x));
+    float farthestz = glm::max(glm::abs(camera.mPosition.z - chunk.mBounds.mMin.z), glm::abs(camera.mPosition.z - chunk.mBounds.mMax.z));
+    float farthestDistance = glm::length(glm::vec2(farthestx, farthestz));
+
+    for (int ilayer = 0; ilayer < MAP_LAYERS_COUNT; ++ilayer)
+    {
+        const MapLayerBand& layerBand = chunk.mLayerBands[ilayer];
+        if (layerBand.mIndicesCount == 0)
+            continue;
+
+        // any line of sight from layer band to camera crosses occluder lids plane, 
+        // if it happens within chunk area plus margin then layer band is hidden
+        if (layerBand.mOccluderLayer > -1 && camera.mCurrentMode == eSceneCameraMode_Perspective)
+        {
+            float occluderHeight = (layerBand.mOccluderLayer + 1) * MAP_BLOCK_LENGTH;
+            float layerBottom = ilayer * MAP_BLOCK_LENGTH;
+            if (camera.mPosition.y > occluderHeight)
+            {
+                float maxSightOffset = farthestDistance * (occluderHeight - layerBottom) / (camera.mPosition.y - layerBottom);
+                if (maxSightOffset < OccludersMarginBlocks * MAP_BLOCK_LENGTH)
+                {
+                    ++viewContext.mRenderStats.mLayerBandsOccludedCount;
+                    continue;
+                }
+            }
+        }
+        AddDrawRange(viewContext, layerBand.mIndicesStart, layerBand.mIndicesCount);
+    }
+}
+
+bool MapRenderer::HasContinuousLids(const Rect2D& mapArea, int layer) const
+{
+    for (int tiley = mapArea.y; tiley < mapArea.y + mapArea.h; ++tiley)
+    for (int tilex = mapArea.x; tilex < mapArea.x + mapArea.w; ++tilex)
+    {
+        // only flat and opaque lids are taken into account
+        BlockStyle* blockInfo = gGameMap.GetBlockClamp(tilex, tiley, layer);
+        if (blockInfo->mFaces[eBlockFace_Lid] == 0 || blockInfo->mIsFlat || blockInfo->mSlopeType)
+            return false;
+    }
+    return true;
+}
+
+void MapRenderer::AddDrawRange(ViewRenderContext& viewContext, unsigned int indicesStart, unsigned int indicesCount)
+{
+    if (viewContext.mDrawRanges.size())
+    {
+        // merge with previous range if contiguous
+        DrawIndicesRange& prevRange = viewContext.mDrawRanges.back();
+        if (prevRange.mIndicesStart + prevRange.mIndicesCount == indicesStart)
+        {
+            prevRange.mIndicesCount += indicesCount;
+            return;
+        }
+    }
+    DrawIndicesRange drawRange;
+    drawRange.mIndicesStart = indicesStart;
+    drawRange.mIndicesCount = indicesCount;
+    viewContext.mDrawRanges.push_back(drawRange);
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "SpriteBatch.h"
 #include "GameDefs.h"
+#include "RenderCommandBuffer.h"
+#include "WorkerThreadPool.h"
 
 class DebugRenderer;
 class RenderView;
@@ -13,9 +15,21 @@ public:
     MapRenderStats() = default;
     void FrameBegin();
     void FrameEnd();
+    // sum up counters of single view
+    void AddViewStats(const MapRenderStats& viewStats);
 
 public:
     int mBlockChunksDrawnCount = 0; // per frame
+    int mCityMeshDrawCallsCount = 0; // per frame
+    int mCityMeshTrianglesCount = 0; // per frame
+    int mLayerBandsOccludedCount = 0; // per frame
+    float mCityMeshCullingTimeMs = 0.0f; // per frame
+    int mObjectsExtractedCount = 0; // per frame, objects visible in at least one view
+    int mObjectsCulledCount = 0; // per frame, objects not visible in any view
+    int mSpritesDrawnCount = 0; // per frame, summary for all views
+    float mExtractionTimeMs = 0.0f; // per frame
+    int mRenderCommandsCount = 0; // per frame, summary for all views
+    float mRecordingTimeMs = 0.0f; // per frame, all views are recorded in parallel
 };
 
 // renders map mesh, peds, cars and map objects
@@ -28,33 +42,103 @@ public:
     bool Initialize();
     void Deinit();
     void RenderFrameBegin();
-    void RenderFrame(RenderView* renderview);
+    // collect sprites of game objects visible in any of views, done once per frame before views get rendered
+    // @param renderviews: Active render views, their cameras must be already computed
+    void ExtractFrameObjects(const std::vector<RenderView*>& renderviews);
+    // record render commands of all views, each view is recorded on its own worker thread
+    // @param renderviews: Active render views, must be called after objects extraction
+    void RecordRenderViews(const std::vector<RenderView*>& renderviews);
+    // submit recorded render commands of view, must be called on graphics thread
+    // @param renderviewIndex: Index of view within recorded views list
+    void RenderFrame(int renderviewIndex);
     void RenderDebug(RenderView* renderview, DebugRenderer& debugRender);
     void RenderFrameEnd();
     void BuildMapMesh();
 
 private:
-    void DrawCityMesh(RenderView* renderview);
+    struct ViewRenderContext;
+    struct MapBlocksChunk;
+
+    void RecordRenderView(ViewRenderContext& viewContext, RenderView* renderview);
+    void RecordCityMesh(ViewRenderContext& viewContext, RenderView* renderview);
+
+    // chunks quadtree routines
+    void BuildChunksTree();
+    void CullChunksTree(ViewRenderContext& viewContext, const GameCamera& camera, int treeLevel, unsigned int nodeCode);
+    void AddChunkDrawRanges(ViewRenderContext& viewContext, const GameCamera& camera, const MapBlocksChunk& chunk);
+    void AddDrawRange(ViewRenderContext& viewContext, unsigned int indicesStart, unsigned int indicesCount);
+
+    // layer bands occlusion routines
+    bool HasContinuousLids(const Rect2D& mapArea, int layer) const;
 
 private:
     enum
     {
         BlocksBatchDims = 22, // 22 x 22 x 6 blocks per batch
         ExtraBlocksPerSide = 4,
+        OccludersMarginBlocks = 8, // lids must cover chunk area with extra margin to occlude layers below
         BlocksBatchesPerSide = ((MAP_DIMENSIONS + (ExtraBlocksPerSide * 2)) + BlocksBatchDims - 1) / BlocksBatchDims,
         BlocksBatchCount = BlocksBatchesPerSide * BlocksBatchesPerSide,
+        // chunks quadtree, leaf nodes are chunks
+        ChunksTreeDims = 16, // power of two, must cover chunks grid
+        ChunksTreeLevels = 5, // root node is level 0
+        ChunksTreeNodesCount = (ChunksTreeDims * ChunksTreeDims * 4 - 1) / 3,
+    };
+    static_assert(ChunksTreeDims >= BlocksBatchesPerSide, "Chunks quadtree is too small");
+    static_assert((1 << (ChunksTreeLevels - 1)) == ChunksTreeDims, "Chunks quadtree levels count mismatch");
+
+    // chunk geometry of single map layer
+    struct MapLayerBand
+    {
+        unsigned int mIndicesStart = 0, mIndicesCount = 0;
+        // lowest layer above which has opaque flat lids over whole chunk area and margin, -1 if there is none
+        // layer band is hidden when camera is above those lids and close enough horizontally
+        int mOccluderLayer = -1;
     };
+
     struct MapBlocksChunk
     {
         cxx::aabbox_t mBounds; // for culling
         // index/vertex data offset in vbo
         unsigned int mIndicesStart = 0, mIndicesCount = 0;
         unsigned int mVerticesStart = 0, mVerticesCount = 0;
+        // layers geometry is stored one after another starting from bottom layer
+        MapLayerBand mLayerBands[MAP_LAYERS_COUNT];
     };
     MapBlocksChunk mMapBlocksChunks[BlocksBatchCount];
 
+    // quadtree node covers contiguous range of chunks, chunks geometry is laid out in morton order
+    struct ChunksTreeNode
+    {
+        cxx::aabbox_t mBounds; // for culling, valid only for non empty nodes
+        unsigned int mIndicesStart = 0, mIndicesCount = 0;
+        int mChunksCount = 0; // non empty chunks within node
+        int mChunkIndex = -1; // leaf nodes only
+    };
+    ChunksTreeNode mChunksTree[ChunksTreeNodesCount]; // nodes are stored level by level
+
+    // merged ranges of city mesh indices to draw in current view
+    struct DrawIndicesRange
+    {
+        unsigned int mIndicesStart = 0, mIndicesCount = 0;
+    };
+
+    // render data of single view, views does not share any writable data so they can be recorded in parallel
+    struct ViewRenderContext
+    {
+        RenderCommandBuffer mCommandBuffer;
+        SpriteBatch mSpriteBatch;
+        std::vector<DrawIndicesRange> mDrawRanges;
+        MapRenderStats mRenderStats;
+    };
+    ViewRenderContext mViewContexts[GAME_MAX_PLAYERS];
+    int mRecordedViewsCount = 0;
+    WorkerThreadPool mViewWorkers; // started once, one thread per view
+
     GpuBuffer* mCityMeshBufferV;
     GpuBuffer* mCityMeshBufferI;
 
-    SpriteBatch mSpriteBatch;
+    // game objects sprites extracted once per frame and shared between all views, never gets flushed
+    SpriteBatch mExtractedSprites;
+    std::vector<cxx::aabbox_t> mExtractedSpritesBounds;
 };
\ No newline at end of file
@@ -7,12 +7,13 @@
 #include "RenderingManager.h"
 #include "PedestrianStates.h"
 #include "Vehicle.h"
+#include "GameObjectsManager.h"
+#include "WorldSnapshot.h"
 
 Pedestrian::Pedestrian(GameObjectID id) : GameObject(eGameObjectType_Pedestrian, id)
     , mPhysicsComponent()
     , mCurrentAnimID(eSpriteAnimID_Null)
     , mController()
-    , mDrawHeight()
     , mPedsListNode(this)
     , mRemapIndex(NO_REMAP)
     , mStatesManager(this)
@@ -85,20 +86,23 @@ void Pedestrian::UpdateFrame(Timespan deltaTime)
 
 void Pedestrian::DrawFrame(SpriteBatch& spriteBatch)
 {
-    glm::vec3 position = mPhysicsComponent->mSmoothPosition;
+    // use draw data collected after game update
+    const PedestriansHotData& hotData = gGameObjectsManager.mPedestriansHotData;
+
+    glm::vec3 position = hotData.mPosition[mHotSlot];
     ComputeDrawHeight(position);
 
-    ePedestrianState currState = GetCurrentStateID();
-    if (currState == ePedestrianState_DrivingCar)
+    float drawHeight = hotData.mDrawHeight[mHotSlot];
+    if (hotData.mStateID[mHotSlot] == ePedestrianState_DrivingCar)
     {
         // dont draw pedestrian if it in car with hard top
-        if (mDrawHeight < mCurrentCar->mDrawHeight)
+        if (drawHeight < mCurrentCar->mDrawHeight)
             return;
     }
 
-    cxx::angle_t rotationAngle = mPhysicsComponent->GetRotationAngle() - cxx::angle_t::from_degrees(SPRITE_ZERO_ANGLE);
+    cxx::angle_t rotationAngle = hotData.mHeading[mHotSlot] - cxx::angle_t::from_degrees(SPRITE_ZERO_ANGLE);
 
-    int spriteLinearIndex = gGameMap.mStyleData.GetSpriteIndex(eSpriteType_Ped, mCurrentAnimState.GetCurrentFrame());
+    int spriteLinearIndex = gGameMap.mStyleData.GetSpriteIndex(eSpriteType_Ped, hotData.mAnimFrame[mHotSlot]);
 
     int remapClut = mRemapIndex == NO_REMAP ? 0 : mRemapIndex + gGameMap.mStyleData.GetPedestrianRemapsBaseIndex();
     gSpriteManager.GetSpriteTexture(mObjectID, spriteLinearIndex, remapClut, mDrawSprite);
@@ -106,7 +110,7 @@ void Pedestrian::DrawFrame(SpriteBatch& spriteBatch)
     mDrawSprite.mPosition = glm::vec2(position.x, position.z);
     mDrawSprite.mScale = SPRITE_SCALE;
     mDrawSprite.mRotateAngle = rotationAngle;
-    mDrawSprite.mHeight = mDrawHeight;
+    mDrawSprite.mHeight = drawHeight;
     mDrawSprite.SetOriginToCenter();
     spriteBatch.DrawSprite(mDrawSprite);
 }
@@ -120,8 +124,14 @@ void Pedestrian::DrawDebug(DebugRenderer& debugRender)
     debugRender.DrawLine(position, position + glm::vec3(signVector.x, 0.0f, signVector.y), COLOR_WHITE);
 }
 
+void Pedestrian::GetDrawBounds(cxx::aabbox_t& outBounds) const
+{
+    gGameObjectsManager.mPedestriansHotData.GetDrawBounds(mHotSlot, outBounds);
+}
+
 void Pedestrian::ComputeDrawHeight(const glm::vec3& position)
 {
+    float& drawHeight = gGameObjectsManager.mPedestriansHotData.mDrawHeight[mHotSlot];
     if (mCurrentCar)
     {
         bool isBike = (mCurrentCar->mCarStyle->mVType == eCarVType_Motorcycle);
@@ -129,11 +139,11 @@ void Pedestrian::ComputeDrawHeight(const glm::vec3& position)
         if ((mCurrentCar->mCarStyle->mConvertible == eCarConvertible_HardTop ||
             mCurrentCar->mCarStyle->mConvertible == eCarConvertible_HardTopAnimated) && !isBike)
         {
-            mDrawHeight = mCurrentCar->mDrawHeight - 0.01f; // todo: magic numbers
+            drawHeight = mCurrentCar->mDrawHeight - 0.01f; // todo: magic numbers
         }
         else
         {
-            mDrawHeight = mCurrentCar->mDrawHeight + 0.01f; // todo: magic numbers
+            drawHeight = mCurrentCar->mDrawHeight + 0.01f; // todo: magic numbers
         }
         return;
     }
@@ -181,7 +191,7 @@ void Pedestrian::ComputeDrawHeight(const glm::vec3& position)
         drawOffset = 0.001f; // todo: magic numbers
     }
 
-    mDrawHeight = maxHeight + drawOffset;
+    drawHeight = maxHeight + drawOffset;
 }
 
 void Pedestrian::ChangeWeapon(eWeaponType weapon)
@@ -205,7 +215,7 @@ void Pedestrian::Die(ePedestrianDeathReason deathReason, Pedestrian* attacker)
 
     PedestrianStateEvent evData { ePedestrianStateEvent_Die };
     evData.mDeathReason = deathReason;
-    evData.mAttacker = attacker;
+    evData.mAttacker = attacker ? attacker->GetHandle() : GameObjectHandle();
     mStatesManager.ChangeState(ePedestrianState_Dead, evData);
 }
 
@@ -235,7 +245,7 @@ void Pedestrian::ExitCar()
 void Pedestrian::ReceiveDamage(eWeaponType weapon, Pedestrian* attacker)
 {
     PedestrianStateEvent evData { ePedestrianStateEvent_DamageFromWeapon };
-    evData.mAttacker = attacker;
+    evData.mAttacker = attacker ? attacker->GetHandle() : GameObjectHandle();
     evData.mWeaponType = weapon;
     mStatesManager.ProcessEvent(evData);
 }
@@ -376,3 +386,59 @@ void Pedestrian::SetDead(ePedestrianDeathReason deathReason)
     }
 }
 
+void Pedestrian::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    const PedestriansHotData& hotData = gGameObjectsManager.mPedestriansHotData;
+
+    snapshot.Write(mCurrentStateTime);
+    snapshot.Write(mWeaponRechargeTime);
+    snapshot.Write(mCtlActions);
+    snapshot.Write(hotData.mDrawHeight[mHotSlot]);
+    snapshot.Write(mRemapIndex);
+    snapshot.Write(mDeathReason);
+
+    GameObjectID carID = mCurrentCar ? mCurrentCar->mObjectID : GAMEOBJECT_ID_NULL;
+    snapshot.Write(carID);
+    snapshot.Write(mCurrentSeat);
+
+    snapshot.Write(mCurrentWeapon);
+    snapshot.Write(mWeaponsAmmo);
+
+    snapshot.Write(mCurrentAnimID);
+    snapshot.Write(mCurrentAnimState);
+    snapshot.Write(mStatesManager.GetCurrentStateID());
+
+    mPhysicsComponent->SaveSnapshot(snapshot);
+}
+
+bool Pedestrian::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    PedestriansHotData& hotData = gGameObjectsManager.mPedestriansHotData;
+
+    GameObjectID carID;
+    ePedestrianState stateID;
+    if (!snapshot.Read(mCurrentStateTime) || !snapshot.Read(mWeaponRechargeTime) || !snapshot.Read(mCtlActions) ||
+        !snapshot.Read(hotData.mDrawHeight[mHotSlot]) || !snapshot.Read(mRemapIndex) || !snapshot.Read(mDeathReason) ||
+        !snapshot.Read(carID) || !snapshot.Read(mCurrentSeat) || 
+        !snapshot.Read(mCurrentWeapon) || !snapshot.Read(mWeaponsAmmo) ||
+        !snapshot.Read(mCurrentAnimID) || !snapshot.Read(mCurrentAnimState) || !snapshot.Read(stateID))
+    {
+        return false;
+    }
+
+    mCurrentCar = nullptr;
+    if (carID != GAMEOBJECT_ID_NULL)
+    {
+        mCurrentCar = gGameObjectsManager.GetCarByID(carID);
+        if (mCurrentCar == nullptr)
+            return false;
+    }
+    mStatesManager.RestoreCurrentState(stateID);
+
+    if (mPhysicsComponent == nullptr)
+    {
+        mPhysicsComponent = gPhysics.CreatePhysicsComponent(this, glm::vec3(), cxx::angle_t());
+        debug_assert(mPhysicsComponent);
+    }
+    return mPhysicsComponent->LoadSnapshot(snapshot);
+}
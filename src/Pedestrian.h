@@ -23,7 +23,6 @@ public:
 
     bool mCtlActions[ePedestrianAction_COUNT]; // control actions
 
-    float mDrawHeight;
     int mRemapIndex;
     
     ePedestrianDeathReason mDeathReason = ePedestrianDeathReason_null; // has meaning only in 'dead state'
@@ -82,6 +81,16 @@ public:
     // detects identifier of current pedestrian state
     ePedestrianState GetCurrentStateID() const;
 
+    // get conservative bounds of pedestrian sprite in world space, used for visibility culling
+    // @param outBounds: Output bounds
+    void GetDrawBounds(cxx::aabbox_t& outBounds) const;
+
+    // write or read pedestrian state, used by world snapshots
+    // referenced car must exist before load, it gets passenger list on its own load
+    // @param snapshot: Snapshot data
+    void SaveSnapshot(WorldSnapshot& snapshot) const;
+    bool LoadSnapshot(WorldSnapshot& snapshot);
+
 private:
     void SetAnimation(eSpriteAnimID animation, eSpriteAnimLoop loopMode);
     void ComputeDrawHeight(const glm::vec3& position);
@@ -95,6 +104,7 @@ private:
     friend class GameObjectsManager;
     friend class PedPhysicsComponent;
     friend class PedestrianStatesManager;
+    friend class PedestriansHotData;
 
     eSpriteAnimID mCurrentAnimID;
     SpriteAnimation mCurrentAnimState;
@@ -104,6 +114,7 @@ private:
 
     // internal stuff that can be touched only by PedestrianManager
     cxx::intrusive_node<Pedestrian> mPedsListNode;
+    int mHotSlot = -1; // index in PedestriansHotData arrays
 };
 
 const int Sizeof_Pedestrian = sizeof(Pedestrian);
\ No newline at end of file
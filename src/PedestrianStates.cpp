@@ -186,19 +186,8 @@ bool PedestrianStatesManager::TryToShoot()
         glm::vec3 pos = mPedestrian->mPhysicsComponent->GetPosition();
         glm::vec2 posA { pos.x, pos.z };
         glm::vec2 posB = posA + (mPedestrian->mPhysicsComponent->GetSignVector() * gGameParams.mWeaponsDistance[mPedestrian->mCurrentWeapon]);
-        // find candidates
-        PhysicsLinecastResult linecastResult;
-        gPhysics.QueryObjectsLinecast(posA, posB, linecastResult);
-        for (int icurr = 0; icurr < linecastResult.mHitsCount; ++icurr)
-        {
-            PedPhysicsComponent* pedBody = linecastResult.mHits[icurr].mPedComponent;
-            if (pedBody == nullptr || pedBody->mReferencePed == mPedestrian) // ignore self
-                continue; 
-
-            // todo: check distance in y direction
-
-            pedBody->mReferencePed->ReceiveDamage(mPedestrian->mCurrentWeapon, mPedestrian);
-        }
+        // candidates are found after all pedestrians are updated
+        gGameObjectsManager.QueueMeleeAttack(mPedestrian, mPedestrian->mCurrentWeapon, posA, posB);
     }
     else
     {
@@ -31,7 +31,7 @@ public:
     Vehicle* mTargetCar = nullptr;
     eCarSeat mTargetSeat;
 
-    Pedestrian* mAttacker = nullptr;
+    GameObjectHandle mAttacker;
     eWeaponType mWeaponType;
 
     ePedestrianDeathReason mDeathReason;
@@ -58,6 +58,10 @@ public:
     // update current state
     void ProcessFrame(Timespan deltaTime);
 
+    // force current state without processing exit and enter handlers, used by world snapshots
+    // @param stateID: State identifier
+    inline void RestoreCurrentState(ePedestrianState stateID) { mCurrentStateID = stateID; }
+
 private:
     void InitFuncsTable();
     
@@ -0,0 +1,100 @@
+#include "stdafx.h"
+#include "PedestriansHotData.h"
+#include "Pedestrian.h"
+#include "PhysicsComponents.h"
+#include "GameMapManager.h"
+
+void PedestriansHotData::AddPedestrian(Pedestrian* pedestrian)
+{
+    debug_assert(pedestrian);
+    debug_assert(pedestrian->mHotSlot == -1);
+
+    pedestrian->mHotSlot = GetCount();
+
+    mPedestrians.push_back(pedestrian);
+    mDrawHeight.push_back(0.0f);
+    mPosition.emplace_back();
+    mHeading.emplace_back();
+    mStateID.push_back(ePedestrianState_Unspecified);
+    mAnimFrame.push_back(0);
+}
+
+void PedestriansHotData::RemovePedestrian(int slotIndex)
+{
+    debug_assert(slotIndex >= 0 && slotIndex < GetCount());
+    debug_assert(mPedestrians[slotIndex]);
+
+    mPedestrians[slotIndex]->mHotSlot = -1;
+    mPedestrians[slotIndex] = nullptr;
+    ++mRemovedCount;
+}
+
+void PedestriansHotData::CompactSlots()
+{
+    if (mRemovedCount == 0)
+        return;
+
+    int numSlots = 0;
+    for (int islot = 0, numOldSlots = GetCount(); islot < numOldSlots; ++islot)
+    {
+        Pedestrian* pedestrian = mPedestrians[islot];
+        if (pedestrian == nullptr)
+            continue;
+
+        if (numSlots != islot)
+        {
+            pedestrian->mHotSlot = numSlots;
+            mPedestrians[numSlots] = pedestrian;
+            mDrawHeight[numSlots] = mDrawHeight[islot];
+            mPosition[numSlots] = mPosition[islot];
+            mHeading[numSlots] = mHeading[islot];
+            mStateID[numSlots] = mStateID[islot];
+            mAnimFrame[numSlots] = mAnimFrame[islot];
+        }
+        ++numSlots;
+    }
+
+    mPedestrians.resize(numSlots);
+    mDrawHeight.resize(numSlots);
+    mPosition.resize(numSlots);
+    mHeading.resize(numSlots);
+    mStateID.resize(numSlots);
+    mAnimFrame.resize(numSlots);
+    mRemovedCount = 0;
+}
+
+void PedestriansHotData::CollectDrawData()
+{
+    for (int islot = 0, numSlots = GetCount(); islot < numSlots; ++islot)
+    {
+        if (mPedestrians[islot])
+        {
+            CollectDrawData(islot);
+        }
+    }
+}
+
+void PedestriansHotData::CollectDrawData(int slotIndex)
+{
+    const Pedestrian* pedestrian = mPedestrians[slotIndex];
+    debug_assert(pedestrian && pedestrian->mPhysicsComponent);
+
+    mPosition[slotIndex] = pedestrian->mPhysicsComponent->mSmoothPosition;
+    mHeading[slotIndex] = pedestrian->mPhysicsComponent->GetRotationAngle();
+    mStateID[slotIndex] = pedestrian->GetCurrentStateID();
+    mAnimFrame[slotIndex] = pedestrian->mCurrentAnimState.GetCurrentFrame();
+}
+
+void PedestriansHotData::GetDrawBounds(int slotIndex, cxx::aabbox_t& outBounds) const
+{
+    int spriteLinearIndex = gGameMap.mStyleData.GetSpriteIndex(eSpriteType_Ped, mAnimFrame[slotIndex]);
+    const SpriteStyle& spriteStyle = gGameMap.mStyleData.mSprites[spriteLinearIndex];
+
+    // sprite might be rotated at any angle so take half of its diagonal
+    float halfExtent = glm::length(glm::vec2(spriteStyle.mWidth, spriteStyle.mHeight)) * SPRITE_SCALE * 0.5f;
+
+    // draw height never goes below body position and never exceeds block above it
+    const glm::vec3& position = mPosition[slotIndex];
+    outBounds.mMin = glm::vec3 { position.x - halfExtent, position.y, position.z - halfExtent };
+    outBounds.mMax = glm::vec3 { position.x + halfExtent, position.y + MAP_BLOCK_LENGTH, position.z + halfExtent };
+}
\ No newline at end of file
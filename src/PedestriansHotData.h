@@ -0,0 +1,48 @@
+#pragma once
+
+#include "GameDefs.h"
+
+// draw data of all pedestrians kept in contiguous arrays indexed by slot,
+// visibility culling touches only these arrays instead of whole objects,
+// slots keep creation order of pedestrians, game update walks them in that order
+class PedestriansHotData final: public cxx::noncopyable
+{
+public:
+    // public for convenience, should not be modified directly
+    std::vector<Pedestrian*> mPedestrians; // null for removed slots until compaction
+    std::vector<float> mDrawHeight; // computed on draw, valid only for pedestrians that passed visibility culling
+    // draw data, collected once per frame after game update
+    std::vector<glm::vec3> mPosition; // smoothed position
+    std::vector<cxx::angle_t> mHeading;
+    std::vector<ePedestrianState> mStateID;
+    std::vector<int> mAnimFrame; // sprite frame of current animation
+
+public:
+    // add pedestrian to the end of arrays, draw data should be collected once pedestrian is spawned
+    // @param pedestrian: Pedestrian
+    void AddPedestrian(Pedestrian* pedestrian);
+
+    // release pedestrian slot in constant time, slot stays empty until compaction
+    // @param slotIndex: Slot index
+    void RemovePedestrian(int slotIndex);
+
+    // shift down slots following removed ones in single pass, keeps order of pedestrians
+    void CompactSlots();
+
+    // get number of slots including removed ones
+    inline int GetCount() const { return static_cast<int>(mPedestrians.size()); }
+
+    // copy positions, states and animation frames of all pedestrians, should be called after game update
+    void CollectDrawData();
+    // copy draw data of single pedestrian, used for pedestrians spawned after draw data was collected
+    // @param slotIndex: Slot index
+    void CollectDrawData(int slotIndex);
+
+    // get conservative bounds of pedestrian sprite in world space from collected draw data, used for visibility culling
+    // @param slotIndex: Slot index
+    // @param outBounds: Output bounds
+    void GetDrawBounds(int slotIndex, cxx::aabbox_t& outBounds) const;
+
+private:
+    int mRemovedCount = 0; // empty slots waiting for compaction
+};
\ No newline at end of file
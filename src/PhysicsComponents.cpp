@@ -3,8 +3,13 @@
 #include "PhysicsDefs.h"
 #include "Pedestrian.h"
 #include "Vehicle.h"
+#include "WorldSnapshot.h"
 #include "PhysicsManager.h"
 
+// car wheel dimensions in map pixels
+const int CarWheelPixelsW = 6;
+const int CarWheelPixelsH = 12;
+
 PhysicsComponent::PhysicsComponent(b2World* physicsWorld)
     : mHeight()
     , mPhysicsWorld(physicsWorld)
@@ -22,7 +27,15 @@ void PhysicsComponent::SetPosition(const glm::vec3& position)
     mHeight = position.y;
 
     b2Vec2 b2position { position.x * PHYSICS_SCALE, position.z * PHYSICS_SCALE };
-    mPhysicsBody->SetTransform(b2position, mPhysicsBody->GetAngle());
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetTransform(b2position, mPhysicsBody->GetAngle());
+    }
+    else
+    {
+        mKinematicPosition = b2position;
+        gPhysics.InvalidateKinematicPedsGrid();
+    }
 
     mPreviousPosition = position;
     mSmoothPosition = position;
@@ -33,7 +46,16 @@ void PhysicsComponent::SetPosition(const glm::vec3& position, cxx::angle_t rotat
     mHeight = position.y;
 
     b2Vec2 b2position { position.x * PHYSICS_SCALE, position.z * PHYSICS_SCALE };
-    mPhysicsBody->SetTransform(b2position, rotationAngle.to_radians());
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetTransform(b2position, rotationAngle.to_radians());
+    }
+    else
+    {
+        mKinematicPosition = b2position;
+        mKinematicAngle = rotationAngle.to_radians();
+        gPhysics.InvalidateKinematicPedsGrid();
+    }
 
     mPreviousPosition = position;
     mSmoothPosition = position;
@@ -41,72 +63,115 @@ void PhysicsComponent::SetPosition(const glm::vec3& position, cxx::angle_t rotat
 
 void PhysicsComponent::SetRotationAngle(cxx::angle_t rotationAngle)
 {
-    mPhysicsBody->SetTransform(mPhysicsBody->GetPosition(), rotationAngle.to_radians());
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetTransform(mPhysicsBody->GetPosition(), rotationAngle.to_radians());
+    }
+    else
+    {
+        mKinematicAngle = rotationAngle.to_radians();
+    }
 }
 
 cxx::angle_t PhysicsComponent::GetRotationAngle() const
 {
-    cxx::angle_t rotationAngle = cxx::angle_t::from_radians(mPhysicsBody->GetAngle());
+    float angleRadians = mPhysicsBody ? mPhysicsBody->GetAngle() : mKinematicAngle;
+
+    cxx::angle_t rotationAngle = cxx::angle_t::from_radians(angleRadians);
     rotationAngle.normalize_angle_180();
     return rotationAngle;
 }
 
 void PhysicsComponent::AddForce(const glm::vec2& force)
 {
+    // forces are ignored without physics body
+    if (mPhysicsBody == nullptr)
+        return;
+
     b2Vec2 b2Force { force.x * PHYSICS_SCALE, force.y * PHYSICS_SCALE };
     mPhysicsBody->ApplyForceToCenter(b2Force, true);
 }
 
 void PhysicsComponent::AddLinearImpulse(const glm::vec2& impulse)
 {
+    // impulses are ignored without physics body
+    if (mPhysicsBody == nullptr)
+        return;
+
     b2Vec2 b2Impulse { impulse.x * PHYSICS_SCALE, impulse.y * PHYSICS_SCALE };
     mPhysicsBody->ApplyLinearImpulseToCenter(b2Impulse, true);
 }
 
 glm::vec3 PhysicsComponent::GetPosition() const
 {
-    const b2Vec2& b2position = mPhysicsBody->GetPosition();
+    const b2Vec2& b2position = mPhysicsBody ? mPhysicsBody->GetPosition() : mKinematicPosition;
     return { b2position.x / PHYSICS_SCALE, mHeight, b2position.y / PHYSICS_SCALE };
 }
 
 glm::vec2 PhysicsComponent::GetLinearVelocity() const
 {
-    const b2Vec2& b2position = mPhysicsBody->GetLinearVelocity();
+    const b2Vec2& b2position = mPhysicsBody ? mPhysicsBody->GetLinearVelocity() : mKinematicVelocity;
     return { b2position.x / PHYSICS_SCALE, b2position.y / PHYSICS_SCALE };
 }
 
 float PhysicsComponent::GetAngularVelocity() const
 {
-    float angularVelocity = glm::degrees(mPhysicsBody->GetAngularVelocity());
+    float angularVelocity = glm::degrees(mPhysicsBody ? mPhysicsBody->GetAngularVelocity() : mKinematicAngularVelocity);
     return angularVelocity;
 }
 
 void PhysicsComponent::AddAngularImpulse(float impulse)
 {
+    // impulses are ignored without physics body
+    if (mPhysicsBody == nullptr)
+        return;
+
     mPhysicsBody->ApplyAngularImpulse(impulse, true);
 }
 
 void PhysicsComponent::SetAngularVelocity(float angularVelocity)
 {
-    mPhysicsBody->SetAngularVelocity(glm::radians(angularVelocity));
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetAngularVelocity(glm::radians(angularVelocity));
+    }
+    else
+    {
+        mKinematicAngularVelocity = glm::radians(angularVelocity);
+    }
 }
 
 void PhysicsComponent::SetLinearVelocity(const glm::vec2& velocity)
 {
     b2Vec2 b2vec { velocity.x * PHYSICS_SCALE, velocity.y * PHYSICS_SCALE };
-    mPhysicsBody->SetLinearVelocity(b2vec);
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetLinearVelocity(b2vec);
+    }
+    else
+    {
+        mKinematicVelocity = b2vec;
+    }
 }
 
 void PhysicsComponent::ClearForces()
 {
     b2Vec2 nullVector { 0.0f, 0.0f };
-    mPhysicsBody->SetLinearVelocity(nullVector);
-    mPhysicsBody->SetAngularVelocity(0.0f);
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetLinearVelocity(nullVector);
+        mPhysicsBody->SetAngularVelocity(0.0f);
+    }
+    else
+    {
+        mKinematicVelocity = nullVector;
+        mKinematicAngularVelocity = 0.0f;
+    }
 }
 
 glm::vec2 PhysicsComponent::GetSignVector() const
 {
-    float angleRadians = mPhysicsBody->GetAngle();
+    float angleRadians = mPhysicsBody ? mPhysicsBody->GetAngle() : mKinematicAngle;
     glm::vec2 signVector 
     {
         cos(angleRadians), sin(angleRadians)
@@ -117,7 +182,7 @@ glm::vec2 PhysicsComponent::GetSignVector() const
 glm::vec2 PhysicsComponent::GetWorldPoint(const glm::vec2& localPosition) const
 {
     b2Vec2 b2LocalPosition { localPosition.x * PHYSICS_SCALE, localPosition.y * PHYSICS_SCALE };
-    b2Vec2 b2WorldPosition = mPhysicsBody->GetWorldPoint(b2LocalPosition);
+    b2Vec2 b2WorldPosition = b2Mul(GetBodyTransform(), b2LocalPosition);
 
     return glm::vec2 { b2WorldPosition.x / PHYSICS_SCALE, b2WorldPosition.y / PHYSICS_SCALE };
 }
@@ -125,11 +190,19 @@ glm::vec2 PhysicsComponent::GetWorldPoint(const glm::vec2& localPosition) const
 glm::vec2 PhysicsComponent::GetLocalPoint(const glm::vec2& worldPosition) const
 {
     b2Vec2 b2WorldPosition { worldPosition.x * PHYSICS_SCALE, worldPosition.y * PHYSICS_SCALE };
-    b2Vec2 b2LocalPosition = mPhysicsBody->GetWorldPoint(b2WorldPosition);
+    b2Vec2 b2LocalPosition = b2MulT(GetBodyTransform(), b2WorldPosition);
 
     return glm::vec2 { b2LocalPosition.x / PHYSICS_SCALE, b2LocalPosition.y / PHYSICS_SCALE };
 }
 
+b2Transform PhysicsComponent::GetBodyTransform() const
+{
+    if (mPhysicsBody)
+        return mPhysicsBody->GetTransform();
+
+    return b2Transform(mKinematicPosition, b2Rot(mKinematicAngle));
+}
+
 void PhysicsComponent::SetRespawned()
 {
     mFalling = false;
@@ -137,12 +210,161 @@ void PhysicsComponent::SetRespawned()
     mFallDistance = 0.0f;
 }
 
+void PhysicsComponent::SetAwake(bool isAwake)
+{
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetAwake(isAwake);
+    }
+}
+
+bool PhysicsComponent::IsSleeping() const
+{
+    return mInactive && mPhysicsBody && !mPhysicsBody->IsAwake();
+}
+
+void PhysicsComponent::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    if (mPhysicsBody)
+    {
+        snapshot.Write(mPhysicsBody->GetPosition());
+        snapshot.Write(mPhysicsBody->GetAngle());
+        snapshot.Write(mPhysicsBody->GetLinearVelocity());
+        snapshot.Write(mPhysicsBody->GetAngularVelocity());
+        snapshot.Write(mPhysicsBody->IsAwake());
+    }
+    else
+    {
+        snapshot.Write(mKinematicPosition);
+        snapshot.Write(mKinematicAngle);
+        snapshot.Write(mKinematicVelocity);
+        snapshot.Write(mKinematicAngularVelocity);
+        snapshot.Write(false);
+    }
+
+    snapshot.Write(mHeight);
+    snapshot.Write(mWaterContact);
+    snapshot.Write(mFalling);
+    snapshot.Write(mFallDistance);
+    snapshot.Write(mPreviousPosition);
+    snapshot.Write(mSmoothPosition);
+    snapshot.Write(mStepMapLayer);
+    snapshot.Write(mInactive);
+}
+
+bool PhysicsComponent::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    b2Vec2 position;
+    float angle;
+    b2Vec2 linearVelocity;
+    float angularVelocity;
+    bool isAwake;
+    if (!snapshot.Read(position) || !snapshot.Read(angle) || !snapshot.Read(linearVelocity) || 
+        !snapshot.Read(angularVelocity) || !snapshot.Read(isAwake))
+    {
+        return false;
+    }
+
+    if (mPhysicsBody)
+    {
+        mPhysicsBody->SetTransform(position, angle);
+        mPhysicsBody->SetLinearVelocity(linearVelocity);
+        mPhysicsBody->SetAngularVelocity(angularVelocity);
+        mPhysicsBody->SetAwake(isAwake);
+    }
+    else
+    {
+        mKinematicPosition = position;
+        mKinematicAngle = angle;
+        mKinematicVelocity = linearVelocity;
+        mKinematicAngularVelocity = angularVelocity;
+    }
+
+    return snapshot.Read(mHeight) && snapshot.Read(mWaterContact) && snapshot.Read(mFalling) && 
+        snapshot.Read(mFallDistance) && snapshot.Read(mPreviousPosition) && snapshot.Read(mSmoothPosition) && 
+        snapshot.Read(mStepMapLayer) && snapshot.Read(mInactive);
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 PedPhysicsComponent::PedPhysicsComponent(b2World* physicsWorld, const glm::vec3& startPosition, cxx::angle_t startRotation)
     : PhysicsComponent(physicsWorld)
     , mPhysicsComponentsListNode(this)
 {
+    CreatePhysicsBody();
+
+    SetPosition(startPosition, startRotation);
+}
+
+PedPhysicsComponent::~PedPhysicsComponent()
+{
+    if (mPhysicsBody)
+    {
+        mPhysicsWorld->DestroyBody(mPhysicsBody);
+        mPhysicsBody = nullptr;
+    }
+}
+
+bool PedPhysicsComponent::IsKinematic() const
+{
+    return mPhysicsBody == nullptr;
+}
+
+void PedPhysicsComponent::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    snapshot.Write(IsKinematic());
+
+    PhysicsComponent::SaveSnapshot(snapshot);
+
+    snapshot.Write(mCarPointLocal);
+    snapshot.Write(mKinematicHoldFrames);
+}
+
+bool PedPhysicsComponent::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    bool isKinematic;
+    if (!snapshot.Read(isKinematic))
+        return false;
+
+    SetKinematic(isKinematic);
+
+    if (!PhysicsComponent::LoadSnapshot(snapshot))
+        return false;
+
+    // car sensor contacts are reported again on next simulation step
+    mContactingCars = 0;
+    return snapshot.Read(mCarPointLocal) && snapshot.Read(mKinematicHoldFrames);
+}
+
+void PedPhysicsComponent::SetKinematic(bool isKinematic)
+{
+    if (isKinematic == IsKinematic())
+        return;
+
+    if (isKinematic)
+    {
+        mKinematicPosition = mPhysicsBody->GetPosition();
+        mKinematicAngle = mPhysicsBody->GetAngle();
+        mKinematicVelocity = mPhysicsBody->GetLinearVelocity();
+        mKinematicAngularVelocity = mPhysicsBody->GetAngularVelocity();
+
+        // contacts are destroyed along with body, contact end events get reported
+        mPhysicsWorld->DestroyBody(mPhysicsBody);
+        mPhysicsBody = nullptr;
+        return;
+    }
+
+    CreatePhysicsBody();
+
+    mPhysicsBody->SetTransform(mKinematicPosition, mKinematicAngle);
+    mPhysicsBody->SetLinearVelocity(mKinematicVelocity);
+    mPhysicsBody->SetAngularVelocity(mKinematicAngularVelocity);
+}
+
+void PedPhysicsComponent::CreatePhysicsBody()
+{
+    debug_assert(mPhysicsBody == nullptr);
+
     // create body
     b2BodyDef bodyDef;
     bodyDef.type = b2_dynamicBody;
@@ -172,12 +394,6 @@ PedPhysicsComponent::PedPhysicsComponent(b2World* physicsWorld, const glm::vec3&
 
     b2Fixture* b2sensorFixture = mPhysicsBody->CreateFixture(&fixtureDef);
     debug_assert(b2fixture);
-
-    SetPosition(startPosition, startRotation);
-}
-
-PedPhysicsComponent::~PedPhysicsComponent()
-{
 }
 
 void PedPhysicsComponent::SimulationStep()
@@ -321,7 +537,16 @@ CarPhysicsComponent::CarPhysicsComponent(b2World* physicsWorld, CarStyle* desc,
 
     SetPosition(startPosition, startRotation);
 
-    SetupWheels();
+    mChassisMass = mPhysicsBody->GetMass();
+    mSingleBodyModel = gSystem.mConfig.mPhysicsSingleBodyVehicles;
+    if (mSingleBodyModel)
+    {
+        SetupSingleBodyWheels();
+    }
+    else
+    {
+        SetupWheels();
+    }
 }
 
 CarPhysicsComponent::~CarPhysicsComponent()
@@ -353,6 +578,87 @@ void CarPhysicsComponent::HandleWaterContact()
     mReferenceCar->ReceiveDamageFromWater();
 }
 
+void CarPhysicsComponent::SetAwake(bool isAwake)
+{
+    PhysicsComponent::SetAwake(isAwake);
+
+    // wheels are connected with joints so they must share chassis state,
+    // otherwise awake wheel will wake up whole island on next step
+    for (WheelData& currWheel: mCarWheels)
+    {
+        if (currWheel.mPhysicsBody)
+        {
+            currWheel.mPhysicsBody->SetAwake(isAwake);
+        }
+    }
+}
+
+void CarPhysicsComponent::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    PhysicsComponent::SaveSnapshot(snapshot);
+
+    snapshot.Write(mSingleBodyModel);
+    for (const WheelData& currWheel: mCarWheels)
+    {
+        if (currWheel.mPhysicsBody == nullptr)
+            continue;
+
+        snapshot.Write(currWheel.mPhysicsBody->GetPosition());
+        snapshot.Write(currWheel.mPhysicsBody->GetAngle());
+        snapshot.Write(currWheel.mPhysicsBody->GetLinearVelocity());
+        snapshot.Write(currWheel.mPhysicsBody->GetAngularVelocity());
+    }
+
+    snapshot.Write(mSteeringAngle);
+    snapshot.Write(mSteeringDirection);
+    snapshot.Write<bool>(mAccelerationEnabled);
+    snapshot.Write<bool>(mDecelerationEnabled);
+    snapshot.Write<bool>(mHandBrakeEnabled);
+    snapshot.Write(mCurrentTraction);
+}
+
+bool CarPhysicsComponent::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    if (!PhysicsComponent::LoadSnapshot(snapshot))
+        return false;
+
+    // vehicle model is selected by config, snapshot must be restored with same settings
+    bool isSingleBodyModel;
+    if (!snapshot.Read(isSingleBodyModel) || isSingleBodyModel != mSingleBodyModel)
+        return false;
+
+    for (WheelData& currWheel: mCarWheels)
+    {
+        if (currWheel.mPhysicsBody == nullptr)
+            continue;
+
+        b2Vec2 position;
+        float angle;
+        b2Vec2 linearVelocity;
+        float angularVelocity;
+        if (!snapshot.Read(position) || !snapshot.Read(angle) || !snapshot.Read(linearVelocity) || !snapshot.Read(angularVelocity))
+            return false;
+
+        currWheel.mPhysicsBody->SetTransform(position, angle);
+        currWheel.mPhysicsBody->SetLinearVelocity(linearVelocity);
+        currWheel.mPhysicsBody->SetAngularVelocity(angularVelocity);
+        currWheel.mPhysicsBody->SetAwake(mPhysicsBody->IsAwake());
+    }
+
+    bool accelerationEnabled;
+    bool decelerationEnabled;
+    bool handBrakeEnabled;
+    if (!snapshot.Read(mSteeringAngle) || !snapshot.Read(mSteeringDirection) || !snapshot.Read(accelerationEnabled) ||
+        !snapshot.Read(decelerationEnabled) || !snapshot.Read(handBrakeEnabled) || !snapshot.Read(mCurrentTraction))
+    {
+        return false;
+    }
+    mAccelerationEnabled = accelerationEnabled;
+    mDecelerationEnabled = decelerationEnabled;
+    mHandBrakeEnabled = handBrakeEnabled;
+    return true;
+}
+
 void CarPhysicsComponent::SimulationStep()
 {
     UpdateWheelFriction(eCarWheelID_Drive);
@@ -383,7 +689,31 @@ void CarPhysicsComponent::GetWheelCorners(eCarWheelID wheelID, glm::vec2 corners
     const WheelData& wheel = mCarWheels[wheelID];
     if (wheel.mPhysicsBody == nullptr)
     {
-        debug_assert(false);
+        debug_assert(mSingleBodyModel);
+
+        // build wheel box around virtual wheel
+        float wheel_size_w = ((1.0f * CarWheelPixelsW) / MAP_PIXELS_PER_TILE) * 0.5f * PHYSICS_SCALE;
+        float wheel_size_h = ((1.0f * CarWheelPixelsH) / MAP_PIXELS_PER_TILE) * 0.5f * PHYSICS_SCALE;
+
+        b2Vec2 position;
+        b2Vec2 forwardNormal;
+        b2Vec2 velocity;
+        GetWheelFrame(wheelID, position, forwardNormal, velocity);
+
+        b2Vec2 forwardExtent = wheel_size_h * forwardNormal;
+        b2Vec2 rightExtent = wheel_size_w * b2Cross(1.0f, forwardNormal);
+        const b2Vec2 points[4] = 
+        {
+            position - forwardExtent - rightExtent,
+            position + forwardExtent - rightExtent,
+            position + forwardExtent + rightExtent,
+            position - forwardExtent + rightExtent,
+        };
+        for (int icorner = 0; icorner < 4; ++icorner)
+        {
+            corners[icorner].x = points[icorner].x / PHYSICS_SCALE;
+            corners[icorner].y = points[icorner].y / PHYSICS_SCALE;
+        }
         return;
     }
 
@@ -401,7 +731,12 @@ bool CarPhysicsComponent::HasWheel(eCarWheelID wheelID) const
 {
     debug_assert(wheelID < eCarWheelID_COUNT);
 
-    return mCarWheels[wheelID].mPhysicsBody != nullptr;
+    return mSingleBodyModel || mCarWheels[wheelID].mPhysicsBody != nullptr;
+}
+
+bool CarPhysicsComponent::IsSingleBodyModel() const
+{
+    return mSingleBodyModel;
 }
 
 void CarPhysicsComponent::SetSteering(int steerDirection)
@@ -430,10 +765,15 @@ glm::vec2 CarPhysicsComponent::GetWheelLateralVelocity(eCarWheelID wheelID) cons
 
     glm::vec2 result_velocity;
 
-    const WheelData& wheel = mCarWheels[wheelID];
-    if (wheel.mPhysicsBody)
+    if (HasWheel(wheelID))
     {
-        b2Vec2 literal_vel = GetWheelLateralVelocity(wheel.mPhysicsBody);
+        b2Vec2 position;
+        b2Vec2 forwardNormal;
+        b2Vec2 velocity;
+        GetWheelFrame(wheelID, position, forwardNormal, velocity);
+
+        const b2Vec2 right_normal = b2Cross(1.0f, forwardNormal);
+        b2Vec2 literal_vel = b2Dot(right_normal, velocity) * right_normal;
         result_velocity.x = literal_vel.x / PHYSICS_SCALE;
         result_velocity.y = literal_vel.y / PHYSICS_SCALE;
     }
@@ -450,12 +790,16 @@ glm::vec2 CarPhysicsComponent::GetWheelForwardVelocity(eCarWheelID wheelID) cons
 
     glm::vec2 result_velocity;
 
-    const WheelData& wheel = mCarWheels[wheelID];
-    if (wheel.mPhysicsBody)
+    if (HasWheel(wheelID))
     {
-        b2Vec2 literal_vel = GetWheelForwardVelocity(wheel.mPhysicsBody);
-        result_velocity.x = literal_vel.x / PHYSICS_SCALE;
-        result_velocity.y = literal_vel.y / PHYSICS_SCALE;
+        b2Vec2 position;
+        b2Vec2 forwardNormal;
+        b2Vec2 velocity;
+        GetWheelFrame(wheelID, position, forwardNormal, velocity);
+
+        b2Vec2 forward_vel = b2Dot(forwardNormal, velocity) * forwardNormal;
+        result_velocity.x = forward_vel.x / PHYSICS_SCALE;
+        result_velocity.y = forward_vel.y / PHYSICS_SCALE;
     }
     else
     {
@@ -470,10 +814,13 @@ glm::vec2 CarPhysicsComponent::GetWheelPosition(eCarWheelID wheelID) const
 
     glm::vec2 position;
 
-    const WheelData& wheel = mCarWheels[wheelID];
-    if (wheel.mPhysicsBody)
+    if (HasWheel(wheelID))
     {
-        b2Vec2 world_center = wheel.mPhysicsBody->GetWorldCenter();
+        b2Vec2 world_center;
+        b2Vec2 forwardNormal;
+        b2Vec2 velocity;
+        GetWheelFrame(wheelID, world_center, forwardNormal, velocity);
+
         position.x = world_center.x / PHYSICS_SCALE;
         position.y = world_center.y / PHYSICS_SCALE;
     }
@@ -514,6 +861,33 @@ void CarPhysicsComponent::SetupWheels()
     mPhysicsBody->ResetMassData();
 }
 
+void CarPhysicsComponent::SetupSingleBodyWheels()
+{
+    // wheels are not simulated as separate bodies, but their mass is added to chassis
+    // so car keeps the same handling as with wheel bodies
+    float wheel_size_w = ((1.0f * CarWheelPixelsW) / MAP_PIXELS_PER_TILE) * PHYSICS_SCALE;
+    float wheel_size_h = ((1.0f * CarWheelPixelsH) / MAP_PIXELS_PER_TILE) * PHYSICS_SCALE;
+    float wheelMass = 1.0f * wheel_size_w * wheel_size_h; // wheel bodies density
+    mWheelInertia = wheelMass * (wheel_size_w * wheel_size_w + wheel_size_h * wheel_size_h) / 12.0f;
+
+    mCarWheels[eCarWheelID_Steering].mLocalPosition.Set(((1.0f * mCarDesc->mSteeringWheelOffset) / MAP_PIXELS_PER_TILE) * PHYSICS_SCALE, 0.0f);
+    mCarWheels[eCarWheelID_Drive].mLocalPosition.Set(((1.0f * mCarDesc->mDriveWheelOffset) / MAP_PIXELS_PER_TILE) * PHYSICS_SCALE, 0.0f);
+
+    // inertia is relative to body origin
+    b2MassData massData;
+    mPhysicsBody->GetMassData(&massData);
+
+    b2Vec2 massCenter = massData.mass * massData.center;
+    for (const WheelData& currWheel: mCarWheels)
+    {
+        massCenter += wheelMass * currWheel.mLocalPosition;
+        massData.mass += wheelMass;
+        massData.I += mWheelInertia + wheelMass * b2Dot(currWheel.mLocalPosition, currWheel.mLocalPosition);
+    }
+    massData.center = (1.0f / massData.mass) * massCenter;
+    mPhysicsBody->SetMassData(&massData);
+}
+
 void CarPhysicsComponent::FreeWheels()
 {
     // destroy joints
@@ -547,9 +921,6 @@ void CarPhysicsComponent::CreateWheel(eCarWheelID wheelID)
 
     debug_assert(wheel.mPhysicsBody == nullptr && wheel.mFixture == nullptr);
 
-    const int wheel_pixels_w = 6;
-    const int wheel_pixels_h = 12;
-
     b2BodyDef bodyDef;
     bodyDef.type = b2_dynamicBody;
     bodyDef.userData = this;
@@ -568,14 +939,15 @@ void CarPhysicsComponent::CreateWheel(eCarWheelID wheelID)
         debug_assert(false);
     }
 
+    wheel.mLocalPosition = bodyDef.position;
     bodyDef.position = mPhysicsBody->GetWorldPoint(bodyDef.position);
 
     wheel.mPhysicsBody = mPhysicsWorld->CreateBody(&bodyDef);
     debug_assert(wheel.mPhysicsBody);
     wheel.mPhysicsBody->SetTransform(bodyDef.position, mPhysicsBody->GetAngle());
 
-    float wheel_size_w = ((1.0f * wheel_pixels_w) / MAP_PIXELS_PER_TILE) * 0.5f * PHYSICS_SCALE;
-    float wheel_size_h = ((1.0f * wheel_pixels_h) / MAP_PIXELS_PER_TILE) * 0.5f * PHYSICS_SCALE;
+    float wheel_size_w = ((1.0f * CarWheelPixelsW) / MAP_PIXELS_PER_TILE) * 0.5f * PHYSICS_SCALE;
+    float wheel_size_h = ((1.0f * CarWheelPixelsH) / MAP_PIXELS_PER_TILE) * 0.5f * PHYSICS_SCALE;
     
     b2PolygonShape shapeDef;
     shapeDef.SetAsBox(wheel_size_h, wheel_size_w); // swap h and w
@@ -587,6 +959,8 @@ void CarPhysicsComponent::CreateWheel(eCarWheelID wheelID)
 
     wheel.mFixture = wheel.mPhysicsBody->CreateFixture(&fixtureDef);
     debug_assert(wheel.mFixture);
+
+    mWheelInertia = wheel.mPhysicsBody->GetInertia();
 }
 
 void CarPhysicsComponent::UpdateSteering()
@@ -597,13 +971,17 @@ void CarPhysicsComponent::UpdateSteering()
 
     float desiredAngle = lockAngle * mSteeringDirection;
 
-    float angleNow = mFrontWheelJoint->GetJointAngle();
+    float angleNow = mFrontWheelJoint ? mFrontWheelJoint->GetJointAngle() : mSteeringAngle;
     float angleToTurn = desiredAngle - angleNow;
 
     angleToTurn = b2Clamp(angleToTurn, -turnPerTimeStep, turnPerTimeStep);
 
     float newAngle = angleNow + angleToTurn;
-    mFrontWheelJoint->SetLimits(newAngle, newAngle);
+    if (mFrontWheelJoint)
+    {
+        mFrontWheelJoint->SetLimits(newAngle, newAngle);
+    }
+    mSteeringAngle = newAngle;
 }
 
 void CarPhysicsComponent::UpdateWheelFriction(eCarWheelID wheelID)
@@ -611,48 +989,48 @@ void CarPhysicsComponent::UpdateWheelFriction(eCarWheelID wheelID)
     const WheelData& wheel = mCarWheels[wheelID];
     float maxLateralImpulse = 8.0f; // todo: magic numbers
 
+    // in single body model wheel forces are applied directly to chassis at wheel position
+    b2Body* wheelBody = wheel.mPhysicsBody ? wheel.mPhysicsBody : mPhysicsBody;
+
+    b2Vec2 position;
+    b2Vec2 forwardNormal;
+    b2Vec2 velocity;
+    GetWheelFrame(wheelID, position, forwardNormal, velocity);
+
     //lateral linear velocity
-    b2Vec2 impulse = mPhysicsBody->GetMass() * -GetWheelLateralVelocity(wheel.mPhysicsBody);
+    const b2Vec2 rightNormal = b2Cross(1.0f, forwardNormal);
+    b2Vec2 impulse = mChassisMass * -(b2Dot(rightNormal, velocity) * rightNormal);
     if (impulse.Length() > maxLateralImpulse)
     {
         impulse *= maxLateralImpulse / impulse.Length();
     }
-    wheel.mPhysicsBody->ApplyLinearImpulse(mCurrentTraction * impulse, wheel.mPhysicsBody->GetWorldCenter(), true);
+    wheelBody->ApplyLinearImpulse(mCurrentTraction * impulse, position, true);
 
     //angular velocity
-    wheel.mPhysicsBody->ApplyAngularImpulse(mCurrentTraction * 0.1f * wheel.mPhysicsBody->GetInertia() * -wheel.mPhysicsBody->GetAngularVelocity(), true);
+    wheelBody->ApplyAngularImpulse(mCurrentTraction * 0.1f * mWheelInertia * -wheelBody->GetAngularVelocity(), true);
 
     //forward linear velocity
-    b2Vec2 currentForwardNormal = GetWheelForwardVelocity(wheel.mPhysicsBody);
-    float currentForwardSpeed = currentForwardNormal.Normalize();
+    float currentForwardSpeed = b2Dot(forwardNormal, velocity);
     float dragForceMagnitude = -2.0f * currentForwardSpeed;
-    wheel.mPhysicsBody->ApplyForce(mCurrentTraction * dragForceMagnitude * currentForwardNormal, wheel.mPhysicsBody->GetWorldCenter(), true);
+    wheelBody->ApplyForce(mCurrentTraction * dragForceMagnitude * forwardNormal, position, true);
 }
 
 void CarPhysicsComponent::UpdateWheelDrive(eCarWheelID wheelID)
 {
     const WheelData& wheel = mCarWheels[wheelID];
 
-    float desiredSpeed = 0.0f;
-    if (mAccelerationEnabled)
-    {
-        desiredSpeed += (1.0f * mCarDesc->mMaxSpeed) * PHYSICS_SCALE;
-    }
-    if (mDecelerationEnabled)
-    {
-        desiredSpeed += (1.0f * mCarDesc->mMinSpeed) * PHYSICS_SCALE;
-    }
-    if (mHandBrakeEnabled)
-    {
-        desiredSpeed = 0.0f;
-    }
-
+    float desiredSpeed = GetDesiredDriveSpeed();
     float maxDriveForce = mCarDesc->mAcceleration * PHYSICS_SCALE;
 
+    b2Body* wheelBody = wheel.mPhysicsBody ? wheel.mPhysicsBody : mPhysicsBody;
+
     // find current speed in forward direction
-    b2Vec2 currentForwardNormal = wheel.mPhysicsBody->GetWorldVector(b2Vec2(1.0f, 0.0f));
+    b2Vec2 position;
+    b2Vec2 currentForwardNormal;
+    b2Vec2 velocity;
+    GetWheelFrame(wheelID, position, currentForwardNormal, velocity);
 
-    float currentSpeed = b2Dot(GetWheelForwardVelocity(wheel.mPhysicsBody), currentForwardNormal);
+    float currentSpeed = b2Dot(velocity, currentForwardNormal);
     float force = 0;
 
     if (fabs(desiredSpeed - currentSpeed) < 0.001f)
@@ -668,17 +1046,44 @@ void CarPhysicsComponent::UpdateWheelDrive(eCarWheelID wheelID)
     }
 
     b2Vec2 forceVec = mCurrentTraction * force * currentForwardNormal;
-    wheel.mPhysicsBody->ApplyForce(forceVec, wheel.mPhysicsBody->GetWorldCenter(), true);
+    wheelBody->ApplyForce(forceVec, position, true);
 }
 
-b2Vec2 CarPhysicsComponent::GetWheelLateralVelocity(b2Body* carWheel) const
+float CarPhysicsComponent::GetDesiredDriveSpeed() const
 {
-	const b2Vec2 right_normal = carWheel->GetWorldVector(b2Vec2(0.0f, 1.0f));
-    return b2Dot(right_normal, carWheel->GetLinearVelocity()) * right_normal;
+    float desiredSpeed = 0.0f;
+    if (mAccelerationEnabled)
+    {
+        desiredSpeed += (1.0f * mCarDesc->mMaxSpeed) * PHYSICS_SCALE;
+    }
+    if (mDecelerationEnabled)
+    {
+        desiredSpeed += (1.0f * mCarDesc->mMinSpeed) * PHYSICS_SCALE;
+    }
+    if (mHandBrakeEnabled)
+    {
+        desiredSpeed = 0.0f;
+    }
+    return desiredSpeed;
 }
 
-b2Vec2 CarPhysicsComponent::GetWheelForwardVelocity(b2Body* carWheel) const
+void CarPhysicsComponent::GetWheelFrame(eCarWheelID wheelID, b2Vec2& position, b2Vec2& forwardNormal, b2Vec2& velocity) const
 {
-	const b2Vec2 forward_normal = carWheel->GetWorldVector(b2Vec2(1.0f, 0.0f));
-    return b2Dot(forward_normal, carWheel->GetLinearVelocity()) * forward_normal;
+    const WheelData& wheel = mCarWheels[wheelID];
+    if (wheel.mPhysicsBody)
+    {
+        position = wheel.mPhysicsBody->GetWorldCenter();
+        forwardNormal = wheel.mPhysicsBody->GetWorldVector(b2Vec2(1.0f, 0.0f));
+        velocity = wheel.mPhysicsBody->GetLinearVelocity();
+        return;
+    }
+
+    debug_assert(mSingleBodyModel);
+
+    // virtual wheel is rigidly attached to chassis, only steering wheel is rotated
+    float wheelAngle = (wheelID == eCarWheelID_Steering) ? mSteeringAngle : 0.0f;
+
+    position = mPhysicsBody->GetWorldPoint(wheel.mLocalPosition);
+    forwardNormal = mPhysicsBody->GetWorldVector(b2Vec2(cosf(wheelAngle), sinf(wheelAngle)));
+    velocity = mPhysicsBody->GetLinearVelocityFromWorldPoint(position);
 }
\ No newline at end of file
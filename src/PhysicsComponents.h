@@ -24,6 +24,10 @@ public:
     glm::vec3 mPreviousPosition;
     glm::vec3 mSmoothPosition; // for rendering only
 
+    int mStepMapLayer = 0; // map layer used for contacts filtering, cached once per simulation step
+
+    bool mInactive = false; // outside of all activity zones, body was put to sleep
+
 public:
     // set/get object's world position and rotation angle
     // @param position: Coordinate
@@ -60,15 +64,34 @@ public:
     void ClearForces();
     // clear state
     void SetRespawned();
+    // wake up or put to sleep physics body
+    // @param isAwake: New state
+    virtual void SetAwake(bool isAwake);
+    // test whether body is sleeping outside of activity zones, its simulation is skipped in that case
+    // note that body might be woken up by contact with other awake body
+    bool IsSleeping() const;
+    // write or read body state and simulation flags, used by world snapshots
+    // @param snapshot: Snapshot data
+    virtual void SaveSnapshot(WorldSnapshot& snapshot) const;
+    virtual bool LoadSnapshot(WorldSnapshot& snapshot);
 
 protected:
     // only derived classes could be instantiated
     PhysicsComponent(b2World* physicsWorld);
     virtual ~PhysicsComponent();
 
+    // get body transform, works without physics body as well
+    b2Transform GetBodyTransform() const;
+
 protected:
     b2World* mPhysicsWorld;
-    b2Body* mPhysicsBody;
+    b2Body* mPhysicsBody; // could be null for kinematic pedestrians
+
+    // body state when there is no physics body
+    b2Vec2 mKinematicPosition {0.0f, 0.0f};
+    b2Vec2 mKinematicVelocity {0.0f, 0.0f};
+    float mKinematicAngle = 0.0f;
+    float mKinematicAngularVelocity = 0.0f;
 };
 
 // pedestrian physics component
@@ -97,10 +120,24 @@ public:
     // test whether pedestrian should collide with other objects depending on its current state
     // @param objCatBits: object categories bits see PHYSICS_OBJCAT_* bits
     bool ShouldCollideWith(unsigned int objCatBits) const;
+    // test whether pedestrian is simulated without physics body, it moves over map blocks grid
+    // and does not collide with other objects
+    bool IsKinematic() const;
+
+    // override PhysicsComponent
+    void SaveSnapshot(WorldSnapshot& snapshot) const override;
+    bool LoadSnapshot(WorldSnapshot& snapshot) override;
+
+private:
+    void CreatePhysicsBody();
+    // switch between full physics body and lightweight kinematic state
+    // @param isKinematic: New state
+    void SetKinematic(bool isKinematic);
 
 private:
     // internal stuff that can be touched only by PhysicsManager
     cxx::intrusive_node<PedPhysicsComponent> mPhysicsComponentsListNode;
+    int mKinematicHoldFrames = 0; // keep full physics for some frames after promoted by query
 };
 
 enum eCarWheelID
@@ -132,11 +169,18 @@ public:
     void ResetDriveState();
     void HandleWaterContact();
 
+    // override PhysicsComponent
+    void SetAwake(bool isAwake) override;
+    void SaveSnapshot(WorldSnapshot& snapshot) const override;
+    bool LoadSnapshot(WorldSnapshot& snapshot) override;
+
     void SimulationStep();
     void GetChassisCorners(glm::vec2 corners[4]) const;
     void GetWheelCorners(eCarWheelID wheelID, glm::vec2 corners[4]) const;
-    // test whether specific wheel exists
+    // test whether specific wheel exists, in single body model wheels are virtual but still reported
     bool HasWheel(eCarWheelID wheelID) const;
+    // test whether car is simulated as single chassis body without wheel bodies and joints
+    bool IsSingleBodyModel() const;
 
     // steering
     // @param steerDirection: see CarSteeringDirection* constants
@@ -157,19 +201,22 @@ private:
     public:
         WheelData() = default;
     public:
-        b2Body* mPhysicsBody = nullptr;
+        b2Body* mPhysicsBody = nullptr; // null in single body model
         b2Fixture* mFixture = nullptr;
+        b2Vec2 mLocalPosition; // wheel center in chassis space
     };
 
     void SetupWheels();
+    void SetupSingleBodyWheels();
     void FreeWheels();
     void CreateWheel(eCarWheelID wheelID);
     void UpdateSteering();
     void UpdateWheelFriction(eCarWheelID wheelID);
     void UpdateWheelDrive(eCarWheelID wheelID);
+    float GetDesiredDriveSpeed() const;
 
-    b2Vec2 GetWheelLateralVelocity(b2Body* carWheel) const;
-    b2Vec2 GetWheelForwardVelocity(b2Body* carWheel) const;
+    // get wheel world center, forward direction and velocity, works for both vehicle models
+    void GetWheelFrame(eCarWheelID wheelID, b2Vec2& position, b2Vec2& forwardNormal, b2Vec2& velocity) const;
 
 private:
     CarStyle* mCarDesc = nullptr;
@@ -179,6 +226,11 @@ private:
     b2RevoluteJoint* mRearWheelJoint = nullptr;
     WheelData mCarWheels[eCarWheelID_COUNT];
 
+    bool mSingleBodyModel = false; // tyre forces are applied analytically to chassis body
+    float mSteeringAngle = 0.0f; // steering wheel angle in radians, single body model only
+    float mChassisMass = 0.0f;
+    float mWheelInertia = 0.0f;
+
     // current drive state
     int mSteeringDirection;
     bool mAccelerationEnabled : 1;
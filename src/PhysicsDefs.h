@@ -1,5 +1,7 @@
 #pragma once
 
+#include "MemoryManager.h"
+
 // forwards
 class PedPhysicsComponent;
 class CarPhysicsComponent;
@@ -9,6 +11,8 @@ class CarPhysicsComponent;
 #define PHYSICS_SIMULATION_STEP (1.0f / 60.0f)
 #define PHYSICS_GRAVITY (9.8f)
 #define PHYSICS_SCALE 10.0f
+#define PHYSICS_ACTIVITY_ZONE_RADIUS (MAP_BLOCK_LENGTH * 16.0f) // bodies within that distance to human character are simulated
+#define PHYSICS_ACTIVITY_ZONE_MARGIN (MAP_BLOCK_LENGTH * 2.0f) // extra distance before put body to sleep, prevents flickering on zone border
 
 // physics objects categories
 enum
@@ -23,7 +27,112 @@ enum
     PHYSICS_OBJCAT_PED_SENSOR = (1 << 5),
 };
 
-const int MaxPhysicsQueryElements = 32;
+// physics counters gathered every simulation step
+enum ePhysicsStatsCounter
+{
+    ePhysicsStatsCounter_BroadphasePairs, // contacts created for overlapping fixtures
+    ePhysicsStatsCounter_TouchingContacts,
+    ePhysicsStatsCounter_PreSolvePedVsMap,
+    ePhysicsStatsCounter_PreSolveCarVsMap,
+    ePhysicsStatsCounter_PreSolvePedVsCar,
+    ePhysicsStatsCounter_PreSolvePedVsPed,
+    ePhysicsStatsCounter_PreSolveOther,
+    ePhysicsStatsCounter_SensorEvents,
+    ePhysicsStatsCounter_COUNT
+};
+
+decl_enum_strings(ePhysicsStatsCounter);
+
+// simulation step stages measured on cpu side
+enum ePhysicsStage
+{
+    ePhysicsStage_WorldStep, // box2d step including contacts filtering
+    ePhysicsStage_KinematicPeds,
+    ePhysicsStage_ComponentsStep, // cars and pedestrians SimulationStep
+    ePhysicsStage_Gravity,
+    ePhysicsStage_COUNT
+};
+
+decl_enum_strings(ePhysicsStage);
+
+const int MaxPhysicsQueryElements = 32; // inline storage capacity of query buffers
+
+// growable storage for physics query results, elements are kept inline until capacity is exceeded
+// and then moved to frame heap memory, so buffer contents should not be kept between frames
+template<typename TElement>
+class PhysicsQueryBuffer: public cxx::noncopyable
+{
+public:
+    PhysicsQueryBuffer() = default;
+    ~PhysicsQueryBuffer()
+    {
+        if (mAllocator)
+        {
+            mAllocator->deallocate(mElements);
+        }
+    }
+    inline void Clear() { mElementsCount = 0; }
+    inline bool IsEmpty() const { return mElementsCount == 0; }
+    inline int GetCount() const { return mElementsCount; }
+
+    inline TElement& operator [] (int elementIndex)
+    {
+        debug_assert(elementIndex > -1 && elementIndex < mElementsCount);
+        return mElements[elementIndex];
+    }
+    inline const TElement& operator [] (int elementIndex) const
+    {
+        debug_assert(elementIndex > -1 && elementIndex < mElementsCount);
+        return mElements[elementIndex];
+    }
+
+    // add new element to buffer, storage grows when needed
+    inline TElement& Append()
+    {
+        if (mElementsCount == mElementsCapacity)
+        {
+            Grow();
+        }
+        TElement& element = mElements[mElementsCount++];
+        element = TElement();
+        return element;
+    }
+
+private:
+    void Grow()
+    {
+        cxx::memory_allocator* allocator = gMemoryManager.mFrameHeapAllocator;
+        if (allocator == nullptr)
+        {
+            allocator = gMemoryManager.mHeapAllocator;
+        }
+        int newCapacity = mElementsCapacity * 2;
+        TElement* newElements = static_cast<TElement*>(allocator->allocate(newCapacity * sizeof(TElement)));
+        if (newElements == nullptr && allocator != gMemoryManager.mHeapAllocator)
+        {
+            // frame heap is exhausted
+            allocator = gMemoryManager.mHeapAllocator;
+            newElements = static_cast<TElement*>(allocator->allocate(newCapacity * sizeof(TElement)));
+        }
+        debug_assert(newElements);
+
+        std::copy(mElements, mElements + mElementsCount, newElements);
+        if (mAllocator)
+        {
+            mAllocator->deallocate(mElements);
+        }
+        mAllocator = allocator;
+        mElements = newElements;
+        mElementsCapacity = newCapacity;
+    }
+
+private:
+    TElement mInlineElements[MaxPhysicsQueryElements];
+    TElement* mElements = mInlineElements;
+    int mElementsCount = 0;
+    int mElementsCapacity = MaxPhysicsQueryElements;
+    cxx::memory_allocator* mAllocator = nullptr; // allocator of external storage, null while inline
+};
 
 // linecast hit info
 struct PhysicsLinecastHit
@@ -65,12 +174,10 @@ struct PhysicsLinecastResult
 {
 public:
     PhysicsLinecastResult() = default;
-    inline void SetNull() { mHitsCount = 0; }
-    inline bool IsNull() const { return mHitsCount == 0; }
-    inline bool IsFull() const { return mHitsCount == MaxPhysicsQueryElements; }
+    inline void SetNull() { mHits.Clear(); }
+    inline bool IsNull() const { return mHits.IsEmpty(); }
 public:
-    int mHitsCount = 0;
-    PhysicsLinecastHit mHits[MaxPhysicsQueryElements];
+    PhysicsQueryBuffer<PhysicsLinecastHit> mHits;
 };
 
 // physical components query result
@@ -78,10 +185,94 @@ struct PhysicsQueryResult
 {
 public:
     PhysicsQueryResult() = default;
-    inline void SetNull() { mElementsCount = 0; }
-    inline bool IsNull() const { return mElementsCount == 0; }
-    inline bool IsFull() const { return mElementsCount == MaxPhysicsQueryElements; }
+    inline void SetNull() { mElements.Clear(); }
+    inline bool IsNull() const { return mElements.IsEmpty(); }
 public:
+    PhysicsQueryBuffer<PhysicsQueryElement> mElements;
+};
+
+// single linecast within batch
+struct PhysicsLinecastQuery
+{
+public:
+    PhysicsLinecastQuery() = default;
+public:
+    glm::vec2 mPointA;
+    glm::vec2 mPointB;
+    // range of query hits in batch
+    int mFirstHit = 0;
+    int mHitsCount = 0;
+};
+
+// single aabbox query within batch
+struct PhysicsBoxQuery
+{
+public:
+    PhysicsBoxQuery() = default;
+public:
+    glm::vec2 mCenter;
+    glm::vec2 mExtents;
+    // range of query elements in batch
+    int mFirstElement = 0;
     int mElementsCount = 0;
-    PhysicsQueryElement mElements[MaxPhysicsQueryElements];
+};
+
+// batch of linecasts processed at once, hits of all queries are written into shared buffer
+struct PhysicsLinecastBatch
+{
+public:
+    PhysicsLinecastBatch() = default;
+    inline void SetNull()
+    {
+        mQueries.Clear();
+        mHits.Clear();
+    }
+    // add linecast to batch
+    // @param pointA, pointB: Line of intersect points
+    // @returns query index
+    inline int AddLinecast(const glm::vec2& pointA, const glm::vec2& pointB)
+    {
+        PhysicsLinecastQuery& query = mQueries.Append();
+        query.mPointA = pointA;
+        query.mPointB = pointB;
+        return mQueries.GetCount() - 1;
+    }
+    inline const PhysicsLinecastHit& GetHit(int queryIndex, int hitIndex) const
+    {
+        debug_assert(hitIndex > -1 && hitIndex < mQueries[queryIndex].mHitsCount);
+        return mHits[mQueries[queryIndex].mFirstHit + hitIndex];
+    }
+public:
+    PhysicsQueryBuffer<PhysicsLinecastQuery> mQueries;
+    PhysicsQueryBuffer<PhysicsLinecastHit> mHits;
+};
+
+// batch of aabbox queries processed at once, elements of all queries are written into shared buffer
+struct PhysicsQueryBatch
+{
+public:
+    PhysicsQueryBatch() = default;
+    inline void SetNull()
+    {
+        mQueries.Clear();
+        mElements.Clear();
+    }
+    // add aabbox query to batch
+    // @param aaboxCenter, aabboxExtents: AABBox area of intersections
+    // @returns query index
+    inline int AddBox(const glm::vec2& aaboxCenter, const glm::vec2& aabboxExtents)
+    {
+        PhysicsBoxQuery& query = mQueries.Append();
+        query.mCenter = aaboxCenter;
+        query.mExtents = aabboxExtents;
+        return mQueries.GetCount() - 1;
+    }
+    inline const PhysicsQueryElement& GetElement(int queryIndex, int elementIndex) const
+    {
+        debug_assert(elementIndex > -1 && elementIndex < mQueries[queryIndex].mElementsCount);
+        return mElements[mQueries[queryIndex].mFirstElement + elementIndex];
+    }
+public:
+    PhysicsQueryBuffer<PhysicsBoxQuery> mQueries;
+    PhysicsQueryBuffer<PhysicsQueryElement> mElements;
 };
\ No newline at end of file
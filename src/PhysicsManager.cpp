@@ -4,6 +4,7 @@
 #include "GameCheatsWindow.h"
 #include "CarnageGame.h"
 #include "Pedestrian.h"
+#include "WorldSnapshot.h"
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -24,6 +25,197 @@ union b2FixtureData_map
 
 static_assert(sizeof(b2FixtureData_map) <= sizeof(void*), "Cannot pack data into pointer");
 
+const int MaxPhysicsWorkerThreads = 16;
+
+// kinematic pedestrians lookup grid params
+const int KinematicPedsGridCellSize = 4; // map blocks
+const int KinematicPedsGridDims = MAP_DIMENSIONS / KinematicPedsGridCellSize;
+
+inline int GetKinematicPedsGridCoord(float mapCoord)
+{
+    // objects outside of map fall into border cells
+    return glm::clamp(static_cast<int>(mapCoord / (KinematicPedsGridCellSize * MAP_BLOCK_LENGTH)), 0, KinematicPedsGridDims - 1);
+}
+
+// physics scheduler params
+const int MaxSimulationStepsPerFrame = 5; // hard limit, prevents spiral of death when steps are too expensive
+const int MaxPendingSimulationSteps = 5; // steps carried over to next frames before time gets dropped
+const int DefaultVelocityIterations = 4;
+const int DefaultPositionIterations = 4;
+const int MinVelocityIterations = 2;
+const int MinPositionIterations = 1;
+const float StepTimeSmoothing = 0.1f;
+const float BudgetRestoreHeadroom = 0.5f; // restore iterations when steps take less than that portion of budget
+const int BudgetRestoreIntervalFrames = 60;
+
+//////////////////////////////////////////////////////////////////////////
+
+int PhysicsStepScheduler::GetStepsToSimulate(int pendingSteps, float budgetMs) const
+{
+    int maxSteps = MaxSimulationStepsPerFrame;
+    if (budgetMs > 0.0f && mSmoothedStepTimeMs > 0.0f)
+    {
+        // at least one step per frame to make progress
+        int stepsWithinBudget = static_cast<int>(budgetMs / mSmoothedStepTimeMs);
+        maxSteps = glm::clamp(stepsWithinBudget, 1, MaxSimulationStepsPerFrame);
+    }
+    return glm::clamp(pendingSteps, 0, maxSteps);
+}
+
+void PhysicsStepScheduler::UpdateStats(int numSteps, double stepsTimeMs, float budgetMs)
+{
+    if (numSteps < 1)
+        return;
+
+    float stepTimeMs = static_cast<float>(stepsTimeMs / numSteps);
+    if (mSmoothedStepTimeMs == 0.0f)
+    {
+        mSmoothedStepTimeMs = stepTimeMs;
+    }
+    mSmoothedStepTimeMs += (stepTimeMs - mSmoothedStepTimeMs) * StepTimeSmoothing;
+
+    if (budgetMs <= 0.0f)
+        return;
+
+    if (stepsTimeMs > budgetMs)
+    {
+        ++mBudgetOverrunsCount;
+        mFramesWithinBudget = 0;
+
+        // cheaper solver is better than losing simulation time
+        if (mVelocityIterations > MinVelocityIterations || mPositionIterations > MinPositionIterations)
+        {
+            mVelocityIterations = glm::max(mVelocityIterations - 1, MinVelocityIterations);
+            mPositionIterations = glm::max(mPositionIterations - 1, MinPositionIterations);
+            gConsole.LogMessage(eLogMessage_Warning, "Physics budget overrun (%.2f ms of %.2f ms), solver iterations lowered to %d/%d",
+                stepsTimeMs, budgetMs, mVelocityIterations, mPositionIterations);
+        }
+        return;
+    }
+
+    if (stepsTimeMs > budgetMs * BudgetRestoreHeadroom)
+    {
+        mFramesWithinBudget = 0;
+        return;
+    }
+
+    if (++mFramesWithinBudget < BudgetRestoreIntervalFrames)
+        return;
+
+    mFramesWithinBudget = 0;
+    if (mVelocityIterations < DefaultVelocityIterations || mPositionIterations < DefaultPositionIterations)
+    {
+        mVelocityIterations = glm::min(mVelocityIterations + 1, DefaultVelocityIterations);
+        mPositionIterations = glm::min(mPositionIterations + 1, DefaultPositionIterations);
+        gConsole.LogMessage(eLogMessage_Debug, "Physics solver iterations restored to %d/%d", mVelocityIterations, mPositionIterations);
+    }
+}
+
+void PhysicsStepScheduler::Reset()
+{
+    mVelocityIterations = DefaultVelocityIterations;
+    mPositionIterations = DefaultPositionIterations;
+    mSmoothedStepTimeMs = 0.0f;
+    mFramesWithinBudget = 0;
+    mBudgetOverrunsCount = 0;
+    mDroppedStepsCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void PhysicsStepStats::SetNull()
+{
+    mStepsCount = 0;
+    for (long long& currCounter: mCounters)
+    {
+        currCounter = 0;
+    }
+    for (double& currTime: mStageTimeMs)
+    {
+        currTime = 0.0;
+    }
+}
+
+void PhysicsStepStats::Accumulate(const PhysicsStepStats& other)
+{
+    mStepsCount += other.mStepsCount;
+    for (int icounter = 0; icounter < ePhysicsStatsCounter_COUNT; ++icounter)
+    {
+        mCounters[icounter] += other.mCounters[icounter];
+    }
+    for (int istage = 0; istage < ePhysicsStage_COUNT; ++istage)
+    {
+        mStageTimeMs[istage] += other.mStageTimeMs[istage];
+    }
+}
+
+void PhysicsStepStats::FormatLogLine(std::string& outputString) const
+{
+    outputString = "Physics step stats (avg per step):";
+
+    double numSteps = std::max(mStepsCount, 1) * 1.0;
+
+    cxx::string_buffer_128 valueString;
+    for (int istage = 0; istage < ePhysicsStage_COUNT; ++istage)
+    {
+        valueString.printf(" %s %.3f ms;", cxx::enum_to_string(static_cast<ePhysicsStage>(istage)), 
+            mStageTimeMs[istage] / numSteps);
+        outputString += valueString.c_str();
+    }
+    for (int icounter = 0; icounter < ePhysicsStatsCounter_COUNT; ++icounter)
+    {
+        valueString.printf(" %s %.1f;", cxx::enum_to_string(static_cast<ePhysicsStatsCounter>(icounter)), 
+            mCounters[icounter] / numSteps);
+        outputString += valueString.c_str();
+    }
+}
+
+long long PhysicsStepStats::GetPreSolveCount() const
+{
+    return mCounters[ePhysicsStatsCounter_PreSolvePedVsMap] + 
+        mCounters[ePhysicsStatsCounter_PreSolveCarVsMap] + 
+        mCounters[ePhysicsStatsCounter_PreSolvePedVsCar] + 
+        mCounters[ePhysicsStatsCounter_PreSolvePedVsPed] + 
+        mCounters[ePhysicsStatsCounter_PreSolveOther];
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// fixture roles in contacts filtering, order is significant
+enum eFixtureRole: unsigned char
+{
+    eFixtureRole_Other,
+    eFixtureRole_MapSolidBlock,
+    eFixtureRole_Ped,
+    eFixtureRole_Car,
+    eFixtureRole_COUNT
+};
+
+// maps fixture category bits to role
+class FixtureRolesTable
+{
+public:
+    FixtureRolesTable()
+    {
+        for (eFixtureRole& currRole: mRoles)
+        {
+            currRole = eFixtureRole_Other;
+        }
+        mRoles[PHYSICS_OBJCAT_MAP_SOLID_BLOCK] = eFixtureRole_MapSolidBlock;
+        mRoles[PHYSICS_OBJCAT_PED] = eFixtureRole_Ped;
+        mRoles[PHYSICS_OBJCAT_CAR] = eFixtureRole_Car;
+    }
+    inline eFixtureRole GetRole(const b2Fixture* fixture) const
+    {
+        unsigned int categoryBits = fixture->GetFilterData().categoryBits;
+        return (categoryBits < CountOf(mRoles)) ? mRoles[categoryBits] : eFixtureRole_Other;
+    }
+private:
+    eFixtureRole mRoles[PHYSICS_OBJCAT_PED_SENSOR << 1];
+};
+
+static const FixtureRolesTable gFixtureRoles;
+
 //////////////////////////////////////////////////////////////////////////
 
 PhysicsManager gPhysics;
@@ -40,16 +232,40 @@ bool PhysicsManager::Initialize()
     mPhysicsWorld = new b2World(gravity);
     mPhysicsWorld->SetContactListener(this);
     CreateMapCollisionShape();
+
+    mSimulationTimeAccumulator = 0.0f;
+    mStepScheduler.Reset();
+    mLastStepStats.SetNull();
+    mFrameStats.SetNull();
+    mTotalStats.SetNull();
+
+    mWorkerThreadsCount = gSystem.mConfig.mPhysicsThreadsCount;
+    if (mWorkerThreadsCount < 1)
+    {
+        mWorkerThreadsCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    mWorkerThreadsCount = glm::clamp(mWorkerThreadsCount, 1, MaxPhysicsWorkerThreads);
+    gConsole.LogMessage(eLogMessage_Debug, "Physics worker threads: %d", mWorkerThreadsCount);
+    mWorkerThreads.Initialize(mWorkerThreadsCount);
     return true;
 }
 
 void PhysicsManager::Deinit()
 {
+    mWorkerThreads.Deinit();
+
     if (mMapCollisionShape)
     {
         mPhysicsWorld->DestroyBody(mMapCollisionShape);
         mMapCollisionShape = nullptr;
     }
+    mMapBuildingLayers.clear();
+    mStepCarsArray.clear();
+    mStepPedsArray.clear();
+    mStepEventsArray.clear();
+    mKinematicPedsCells.clear();
+    mKinematicPedsGrid.clear();
+    mKinematicPedsGridDirty = true;
     SafeDelete(mPhysicsWorld);
 }
 
@@ -57,29 +273,69 @@ void PhysicsManager::UpdateFrame(Timespan deltaTime)
 {
     mSimulationTimeAccumulator += deltaTime.ToSeconds();
 
-    const int MaxSimulationStepsPerFrame = 5;
-    int numSimulations = static_cast<int>(mSimulationTimeAccumulator / PHYSICS_SIMULATION_STEP);
-    if (numSimulations > 0)
+    const float budgetMs = gSystem.mConfig.mPhysicsFrameBudgetMs;
+
+    int pendingSteps = static_cast<int>(mSimulationTimeAccumulator / PHYSICS_SIMULATION_STEP);
+    int numSimulations = mStepScheduler.GetStepsToSimulate(pendingSteps, budgetMs);
+    mSimulationTimeAccumulator -= (numSimulations * PHYSICS_SIMULATION_STEP);
+    debug_assert(numSimulations <= MaxSimulationStepsPerFrame);
+
+    // steps that not fit in current frame are carried over to next frames, but when too much time is pending
+    // it gets dropped and simulation runs slower than real time
+    const float maxPendingTime = MaxPendingSimulationSteps * PHYSICS_SIMULATION_STEP;
+    if (mSimulationTimeAccumulator > maxPendingTime)
     {
-        mSimulationTimeAccumulator -= (numSimulations * PHYSICS_SIMULATION_STEP);
-        numSimulations = glm::min(numSimulations, MaxSimulationStepsPerFrame);
+        int droppedSteps = static_cast<int>(ceilf((mSimulationTimeAccumulator - maxPendingTime) / PHYSICS_SIMULATION_STEP));
+        mSimulationTimeAccumulator -= (droppedSteps * PHYSICS_SIMULATION_STEP);
+        if (mSimulationStepsDropped == 0)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Physics is behind real time, %d simulation steps dropped", droppedSteps);
+        }
+        mSimulationStepsDropped = droppedSteps;
+        mStepScheduler.mDroppedStepsCount += droppedSteps;
     }
-    debug_assert(numSimulations <= MaxSimulationStepsPerFrame);
-    debug_assert(mSimulationTimeAccumulator < PHYSICS_SIMULATION_STEP && mSimulationTimeAccumulator > -0.01f);
+    else
+    {
+        mSimulationStepsDropped = 0;
+    }
+    debug_assert(mSimulationTimeAccumulator > -0.01f);
 
+    // queries are done by game logic between physics updates
+    mQueriesCount = mQueriesCounter;
+    mQueriesTimeMs = mQueriesTimeCounter;
+    mQueriesCounter = 0;
+    mQueriesTimeCounter = 0.0;
+
+    double simulationStartTime = gSystem.GetSysSeconds();
+    mFrameStats.SetNull();
+    UpdateActivityZones();
     for (int icurrStep = 0; icurrStep < numSimulations; ++icurrStep)
     {
         ProcessSimulationStep(icurrStep == (numSimulations - 1));
     }
+    mSimulationStepsCount = numSimulations;
+    mSimulationTimeMs = (gSystem.GetSysSeconds() - simulationStartTime) * 1000.0;
+    mStepScheduler.UpdateStats(numSimulations, mSimulationTimeMs, budgetMs);
 
     ProcessInterpolation();
 }
 
-void PhysicsManager::ProcessSimulationStep(bool resetPreviousState)
+void PhysicsManager::SaveSnapshot(WorldSnapshot& snapshot) const
 {
-    const int velocityIterations = 4;
-    const int positionIterations = 4;
+    snapshot.Write(mSimulationTimeAccumulator);
+    snapshot.Write(mStepScheduler);
+}
+
+bool PhysicsManager::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    RecreatePhysicsWorld();
+    InvalidateKinematicPedsGrid();
 
+    return snapshot.Read(mSimulationTimeAccumulator) && snapshot.Read(mStepScheduler);
+}
+
+void PhysicsManager::ProcessSimulationStep(bool resetPreviousState)
+{
     if (resetPreviousState)
     {
         for (CarPhysicsComponent* currComponent: mCarsBodiesList)
@@ -93,26 +349,315 @@ void PhysicsManager::ProcessSimulationStep(bool resetPreviousState)
         }  
     }
 
-    mPhysicsWorld->Step(PHYSICS_SIMULATION_STEP, velocityIterations, positionIterations);
+    UpdateStepMapContext();
+
+    mCurrentStepStats.SetNull();
+    mCurrentStepStats.mStepsCount = 1;
+
+    double stageStartTime = gSystem.GetSysSeconds();
+    mPhysicsWorld->Step(PHYSICS_SIMULATION_STEP, mStepScheduler.mVelocityIterations, mStepScheduler.mPositionIterations);
+    mCurrentStepStats.mStageTimeMs[ePhysicsStage_WorldStep] = (gSystem.GetSysSeconds() - stageStartTime) * 1000.0;
+
+    mCurrentStepStats.mCounters[ePhysicsStatsCounter_BroadphasePairs] = mPhysicsWorld->GetContactCount();
+    for (b2Contact* currContact = mPhysicsWorld->GetContactList(); currContact; currContact = currContact->GetNext())
+    {
+        if (currContact->IsTouching())
+        {
+            ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_TouchingContacts];
+        }
+    }
+
+    stageStartTime = gSystem.GetSysSeconds();
+    KinematicPedsStep();
+    mCurrentStepStats.mStageTimeMs[ePhysicsStage_KinematicPeds] = (gSystem.GetSysSeconds() - stageStartTime) * 1000.0;
 
-    // process cars physics components
+    stageStartTime = gSystem.GetSysSeconds();
+
+    // process cars physics components, each car touches only its own bodies so they are processed in parallel
+    mStepCarsArray.clear();
     for (CarPhysicsComponent* currComponent: mCarsBodiesList)
     {
-        currComponent->SimulationStep();
+        if (currComponent->IsSleeping())
+            continue;
+
+        mStepCarsArray.push_back(currComponent);
     }
 
+    ParallelFor(static_cast<int>(mStepCarsArray.size()), [this](int firstElement, int lastElement)
+        {
+            for (int icurr = firstElement; icurr < lastElement; ++icurr)
+            {
+                mStepCarsArray[icurr]->SimulationStep();
+            }
+        });
+
     // process peds physics components
+    // attached pedestrians are moved with SetTransform which modifies shared broadphase, keep it serial
     for (PedPhysicsComponent* currComponent: mPedsBodiesList)
     {
+        if (currComponent->IsSleeping() || currComponent->IsKinematic())
+            continue;
+
         currComponent->SimulationStep();
     }
+    mCurrentStepStats.mStageTimeMs[ePhysicsStage_ComponentsStep] = (gSystem.GetSysSeconds() - stageStartTime) * 1000.0;
 
+    stageStartTime = gSystem.GetSysSeconds();
     FixedStepGravity();
+    mCurrentStepStats.mStageTimeMs[ePhysicsStage_Gravity] = (gSystem.GetSysSeconds() - stageStartTime) * 1000.0;
+
+    mLastStepStats = mCurrentStepStats;
+    mFrameStats.Accumulate(mCurrentStepStats);
+    mTotalStats.Accumulate(mCurrentStepStats);
+}
+
+void PhysicsManager::UpdateStepMapContext()
+{
+    // sleeping bodies are not moving so cached layer is still valid
+    for (CarPhysicsComponent* currComponent: mCarsBodiesList)
+    {
+        if (currComponent->IsSleeping())
+            continue;
+
+        currComponent->mStepMapLayer = (int) (currComponent->mHeight + 0.5f);
+    }
+
+    // pedestrians collide with map depending on ground height under them
+    for (PedPhysicsComponent* currComponent: mPedsBodiesList)
+    {
+        if (currComponent->IsSleeping() || currComponent->IsKinematic())
+            continue;
+
+        float height = gGameMap.GetHeightAtPosition(currComponent->GetPosition());
+        currComponent->mStepMapLayer = (int) (height + 0.5f);
+    }
+}
+
+void PhysicsManager::UpdateActivityZones()
+{
+    glm::vec2 zonesCenters[GAME_MAX_PLAYERS];
+    int numZones = 0;
+
+    for (const CarnageGame::HumanCharacterSlot& currSlot: gCarnageGame.mHumanSlot)
+    {
+        if (currSlot.mCharPedestrian == nullptr)
+            continue;
+
+        glm::vec3 position = currSlot.mCharPedestrian->mPhysicsComponent->GetPosition();
+        zonesCenters[numZones++] = glm::vec2(position.x, position.z);
+    }
+
+    mInactiveBodiesCount = 0;
+    mSleepingBodiesCount = 0;
+
+    auto UpdateComponentActivity = [&](PhysicsComponent* component, bool keepActive)
+    {
+        if (!keepActive)
+        {
+            // body already inactive must come closer to be woken up
+            float zoneRadius = PHYSICS_ACTIVITY_ZONE_RADIUS;
+            if (!component->mInactive)
+            {
+                zoneRadius += PHYSICS_ACTIVITY_ZONE_MARGIN;
+            }
+
+            glm::vec3 position = component->GetPosition();
+            glm::vec2 position2d (position.x, position.z);
+            // no human characters, everything is simulated
+            keepActive = (numZones == 0);
+            for (int icurrZone = 0; icurrZone < numZones && !keepActive; ++icurrZone)
+            {
+                keepActive = glm::distance2(zonesCenters[icurrZone], position2d) < (zoneRadius * zoneRadius);
+            }
+        }
+
+        if (component->mInactive == keepActive)
+        {
+            component->mInactive = !keepActive;
+            component->SetAwake(keepActive);
+        }
+
+    };
+
+    auto CountComponentActivity = [this](PhysicsComponent* component)
+    {
+        if (component->mInactive)
+        {
+            ++mInactiveBodiesCount;
+        }
+
+        if (component->IsSleeping())
+        {
+            ++mSleepingBodiesCount;
+        }
+    };
+
+    for (CarPhysicsComponent* currComponent: mCarsBodiesList)
+    {
+        UpdateComponentActivity(currComponent, false);
+        CountComponentActivity(currComponent);
+    }
+
+    mKinematicPedsCount = 0;
+    for (PedPhysicsComponent* currComponent: mPedsBodiesList)
+    {
+        // pedestrian inside car follows its car, falling one should land first
+        bool keepActive = (currComponent->mReferencePed->mCurrentCar != nullptr) || currComponent->mFalling;
+        if (currComponent->mKinematicHoldFrames > 0)
+        {
+            --currComponent->mKinematicHoldFrames;
+            keepActive = true;
+        }
+        UpdateComponentActivity(currComponent, keepActive);
+
+        // inactive pedestrians are moved over map grid without physics body
+        currComponent->SetKinematic(currComponent->mInactive);
+        if (currComponent->IsKinematic())
+        {
+            ++mKinematicPedsCount;
+        }
+        CountComponentActivity(currComponent);
+    }
+}
+
+void PhysicsManager::KinematicPedsStep()
+{
+    mStepPedsArray.clear();
+    for (PedPhysicsComponent* currComponent: mPedsBodiesList)
+    {
+        if (currComponent->IsKinematic())
+        {
+            mStepPedsArray.push_back(currComponent);
+        }
+    }
+
+    ParallelFor(static_cast<int>(mStepPedsArray.size()), [this](int firstElement, int lastElement)
+        {
+            for (int icurr = firstElement; icurr < lastElement; ++icurr)
+            {
+                MoveKinematicPed(mStepPedsArray[icurr]);
+            }
+        });
+
+    InvalidateKinematicPedsGrid();
+}
+
+void PhysicsManager::MoveKinematicPed(PedPhysicsComponent* component)
+{
+    component->mKinematicAngle += component->mKinematicAngularVelocity * PHYSICS_SIMULATION_STEP;
+
+    glm::vec2 velocity = component->GetLinearVelocity();
+    if (glm::length2(velocity) < 0.0001f)
+        return;
+
+    glm::vec3 position = component->GetPosition();
+
+    // move along each axis separately so pedestrian slides along walls
+    for (int iaxis = 0; iaxis < 2; ++iaxis)
+    {
+        float offset = velocity[iaxis] * PHYSICS_SIMULATION_STEP;
+        if (offset == 0.0f)
+            continue;
+
+        glm::vec3 newPosition = position;
+        glm::vec3 boundsPosition = position;
+        float boundsOffset = (offset > 0.0f) ? PHYSICS_PED_BOUNDING_SPHERE_RADIUS : -PHYSICS_PED_BOUNDING_SPHERE_RADIUS;
+        if (iaxis == 0)
+        {
+            newPosition.x += offset;
+            boundsPosition.x += offset + boundsOffset;
+        }
+        else
+        {
+            newPosition.z += offset;
+            boundsPosition.z += offset + boundsOffset;
+        }
+
+        if (!CanKinematicPedMoveTo(position, boundsPosition))
+        {
+            if (iaxis == 0)
+            {
+                component->mKinematicVelocity.x = 0.0f;
+            }
+            else
+            {
+                component->mKinematicVelocity.y = 0.0f;
+            }
+            continue;
+        }
+        position = newPosition;
+    }
+
+    component->mKinematicPosition.Set(position.x * PHYSICS_SCALE, position.z * PHYSICS_SCALE);
+    component->mHeight = gGameMap.GetHeightAtPosition(position);
+}
+
+bool PhysicsManager::CanKinematicPedMoveTo(const glm::vec3& position, const glm::vec3& targetPosition) const
+{
+    int mapx = static_cast<int>(targetPosition.x);
+    int mapz = static_cast<int>(targetPosition.z);
+    if (mapx < 0 || mapz < 0 || mapx >= MAP_DIMENSIONS || mapz >= MAP_DIMENSIONS)
+        return false;
+
+    int map_layer = static_cast<int>(position.y + 0.5f);
+    if (HasCollisionPedestrianVsMap(mapx, mapz, map_layer))
+        return false;
+
+    // kinematic pedestrians never fall from height and never walk into water
+    float targetHeight = gGameMap.GetHeightAtPosition(targetPosition, false);
+    if ((position.y - targetHeight) > (MAP_BLOCK_LENGTH - 0.01f))
+        return false;
+
+    BlockStyle* targetTile = gGameMap.GetBlockClamp(mapx, mapz, static_cast<int>(targetHeight));
+    if (targetTile->mGroundType == eGroundType_Water)
+        return false;
+
+    return true;
+}
+
+void PhysicsManager::PromoteKinematicPed(PedPhysicsComponent* component)
+{
+    debug_assert(component->IsKinematic());
+
+    const int KinematicHoldFrames = 60;
+
+    component->SetKinematic(false);
+    component->mInactive = false;
+    component->mKinematicHoldFrames = KinematicHoldFrames;
+}
+
+void PhysicsManager::ParallelFor(int numElements, const std::function<void(int, int)>& rangeFunc)
+{
+    // waking workers is not free, small workloads are processed serially
+    const int MinElementsPerThread = 64;
+
+    int numThreads = glm::clamp(numElements / MinElementsPerThread, 1, mWorkerThreadsCount);
+    if (numThreads < 2)
+    {
+        if (numElements > 0)
+        {
+            rangeFunc(0, numElements);
+        }
+        return;
+    }
+
+    int elementsPerThread = (numElements + numThreads - 1) / numThreads;
+
+    mWorkerThreads.RunChunks(numThreads, [numElements, elementsPerThread, &rangeFunc](int ichunk)
+        {
+            int firstElement = ichunk * elementsPerThread;
+            int lastElement = glm::min(firstElement + elementsPerThread, numElements);
+            if (firstElement < lastElement)
+            {
+                rangeFunc(firstElement, lastElement);
+            }
+        });
 }
 
 void PhysicsManager::ProcessInterpolation()
 {
-    float mixFactor = mSimulationTimeAccumulator / PHYSICS_SIMULATION_STEP;
+    // accumulator might hold more than one step when simulation is behind
+    float mixFactor = glm::min(mSimulationTimeAccumulator / PHYSICS_SIMULATION_STEP, 1.0f);
 
     for (CarPhysicsComponent* currComponent: mCarsBodiesList)
     {
@@ -155,44 +700,99 @@ void PhysicsManager::CreateMapCollisionShape()
 
     mMapCollisionShape = mPhysicsWorld->CreateBody(&bodyDef);
 
-    int numFixtures = 0;
-    // for each block create fixture
-    for (int x = 0; x < MAP_DIMENSIONS; ++x)
-    for (int y = 0; y < MAP_DIMENSIONS; ++y)
-    for (int layer = 0; layer < MAP_LAYERS_COUNT; ++layer)
+    auto is_walkable = [](eGroundType gtype)
     {
-        BlockStyle* blockData = gGameMap.GetBlock(x, y, layer);
-        debug_assert(blockData);
+        return gtype == eGroundType_Field || gtype == eGroundType_Pawement || gtype == eGroundType_Road;
+    };
 
-        if (blockData->mGroundType != eGroundType_Building)
-            continue;
+    // fill collision lookup grid and find blocks that need collision, 
+    // these are building blocks with walkable neighbour on same layer
+    mMapBuildingLayers.assign(MAP_DIMENSIONS * MAP_DIMENSIONS, 0);
 
-        // checek blox is inner
+    std::vector<bool> solidBlocks(MAP_DIMENSIONS * MAP_DIMENSIONS, false);
+    mMapSolidBlocksCount = 0;
+
+    for (int y = 0; y < MAP_DIMENSIONS; ++y)
+    for (int x = 0; x < MAP_DIMENSIONS; ++x)
+    {
+        const int cellIndex = y * MAP_DIMENSIONS + x;
+        for (int layer = 0; layer < MAP_LAYERS_COUNT; ++layer)
         {
+            BlockStyle* blockData = gGameMap.GetBlock(x, y, layer);
+            debug_assert(blockData);
+
+            if (blockData->mGroundType != eGroundType_Building)
+                continue;
+
+            mMapBuildingLayers[cellIndex] |= (1 << layer);
+
+            if (solidBlocks[cellIndex])
+                continue;
+
+            // check block is inner
             BlockStyle* neighbourE = gGameMap.GetBlockClamp(x + 1, y, layer); 
             BlockStyle* neighbourW = gGameMap.GetBlockClamp(x - 1, y, layer); 
             BlockStyle* neighbourN = gGameMap.GetBlockClamp(x, y - 1, layer); 
             BlockStyle* neighbourS = gGameMap.GetBlockClamp(x, y + 1, layer);
 
-            auto is_walkable = [](eGroundType gtype)
+            if (is_walkable(neighbourE->mGroundType) || is_walkable(neighbourW->mGroundType) ||
+                is_walkable(neighbourN->mGroundType) || is_walkable(neighbourS->mGroundType))
             {
-                return gtype == eGroundType_Field || gtype == eGroundType_Pawement || gtype == eGroundType_Road;
-            };
+                solidBlocks[cellIndex] = true;
+                ++mMapSolidBlocksCount;
+            }
+        }
+    }
+
+    // merge solid blocks into rectangles greedily, single fixture per rectangle,
+    // blocks within rectangle must have same building layers so collision decision is same for all of them
+    mMapFixturesCount = 0;
 
-            if (!is_walkable(neighbourE->mGroundType) && !is_walkable(neighbourW->mGroundType) &&
-                !is_walkable(neighbourN->mGroundType) && !is_walkable(neighbourS->mGroundType))
+    for (int y = 0; y < MAP_DIMENSIONS; ++y)
+    for (int x = 0; x < MAP_DIMENSIONS; ++x)
+    {
+        if (!solidBlocks[y * MAP_DIMENSIONS + x])
+            continue;
+
+        const unsigned char buildingLayers = mMapBuildingLayers[y * MAP_DIMENSIONS + x];
+        auto can_merge = [&solidBlocks, buildingLayers, this](int cellx, int celly)
+        {
+            const int cellIndex = celly * MAP_DIMENSIONS + cellx;
+            return solidBlocks[cellIndex] && mMapBuildingLayers[cellIndex] == buildingLayers;
+        };
+
+        // extend along x first
+        int sizex = 1;
+        for (; x + sizex < MAP_DIMENSIONS && can_merge(x + sizex, y); ++sizex) {}
+
+        // then extend along y while whole row matches
+        int sizey = 1;
+        for (; y + sizey < MAP_DIMENSIONS; ++sizey)
+        {
+            bool rowMatches = true;
+            for (int ix = x; ix < x + sizex && rowMatches; ++ix)
             {
-                continue; // just ignore this block 
+                rowMatches = can_merge(ix, y + sizey);
             }
+            if (!rowMatches)
+                break;
+        }
+
+        // mark merged blocks as processed
+        for (int iy = y; iy < y + sizey; ++iy)
+        for (int ix = x; ix < x + sizex; ++ix)
+        {
+            solidBlocks[iy * MAP_DIMENSIONS + ix] = false;
         }
 
         b2PolygonShape b2shapeDef;
         b2Vec2 center { 
-            ((x * MAP_BLOCK_LENGTH) + (MAP_BLOCK_LENGTH * 0.5f)) * PHYSICS_SCALE, 
-            ((y * MAP_BLOCK_LENGTH) + (MAP_BLOCK_LENGTH * 0.5f)) * PHYSICS_SCALE
+            ((x * MAP_BLOCK_LENGTH) + (sizex * MAP_BLOCK_LENGTH * 0.5f)) * PHYSICS_SCALE, 
+            ((y * MAP_BLOCK_LENGTH) + (sizey * MAP_BLOCK_LENGTH * 0.5f)) * PHYSICS_SCALE
         };
-        b2shapeDef.SetAsBox(MAP_BLOCK_LENGTH * 0.5f * PHYSICS_SCALE, MAP_BLOCK_LENGTH * 0.5f * PHYSICS_SCALE, center, 0.0f);
+        b2shapeDef.SetAsBox(sizex * MAP_BLOCK_LENGTH * 0.5f * PHYSICS_SCALE, sizey * MAP_BLOCK_LENGTH * 0.5f * PHYSICS_SCALE, center, 0.0f);
 
+        // any block of rectangle is suitable for collision lookups
         b2FixtureData_map fixtureData;
         fixtureData.mX = x;
         fixtureData.mZ = y;
@@ -206,9 +806,58 @@ void PhysicsManager::CreateMapCollisionShape()
         b2Fixture* b2fixture = mMapCollisionShape->CreateFixture(&b2fixtureDef);
         debug_assert(b2fixture);
 
-        ++numFixtures;
-        break; // single fixture per block column
+        ++mMapFixturesCount;
+    }
+
+    gConsole.LogMessage(eLogMessage_Info, "Map collision: %d fixtures for %d solid blocks", mMapFixturesCount, mMapSolidBlocksCount);
+}
+
+void PhysicsManager::RecreatePhysicsWorld()
+{
+    debug_assert(!mPedsBodiesList.has_elements() && !mCarsBodiesList.has_elements());
+
+    // body keeps fixtures in reverse creation order, copy them in original order 
+    // so broadphase of new world is built same way
+    std::vector<b2Fixture*> mapFixtures;
+    for (b2Fixture* currFixture = mMapCollisionShape->GetFixtureList(); currFixture; currFixture = currFixture->GetNext())
+    {
+        mapFixtures.push_back(currFixture);
+    }
+
+    b2Vec2 gravity {0.0f, 0.0f};
+    b2World* physicsWorld = new b2World(gravity);
+    physicsWorld->SetContactListener(this);
+
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_staticBody;
+
+    b2Body* mapCollisionShape = physicsWorld->CreateBody(&bodyDef);
+    for (auto fixturesIterator = mapFixtures.rbegin(); fixturesIterator != mapFixtures.rend(); ++fixturesIterator)
+    {
+        b2Fixture* sourceFixture = *fixturesIterator;
+
+        b2FixtureDef b2fixtureDef;
+        b2fixtureDef.density = 0.0f;
+        b2fixtureDef.shape = sourceFixture->GetShape();
+        b2fixtureDef.userData = sourceFixture->GetUserData();
+        b2fixtureDef.filter = sourceFixture->GetFilterData();
+
+        b2Fixture* b2fixture = mapCollisionShape->CreateFixture(&b2fixtureDef);
+        debug_assert(b2fixture);
     }
+
+    // bodies that still exist in previous world are destroyed along with it
+    SafeDelete(mPhysicsWorld);
+    mPhysicsWorld = physicsWorld;
+    mMapCollisionShape = mapCollisionShape;
+}
+
+bool PhysicsManager::IsMapBuildingBlock(int mapx, int mapz, int layer) const
+{
+    layer = glm::clamp(layer, 0, MAP_LAYERS_COUNT - 1);
+    mapx = glm::clamp(mapx, 0, MAP_DIMENSIONS - 1);
+    mapz = glm::clamp(mapz, 0, MAP_DIMENSIONS - 1);
+    return (mMapBuildingLayers[mapz * MAP_DIMENSIONS + mapx] & (1 << layer)) > 0;
 }
 
 void PhysicsManager::DestroyPhysicsComponent(PedPhysicsComponent* object)
@@ -222,6 +871,10 @@ void PhysicsManager::DestroyPhysicsComponent(PedPhysicsComponent* object)
     {
         debug_assert(false);
     }
+    if (object->IsKinematic())
+    {
+        InvalidateKinematicPedsGrid();
+    }
     mPedsBodiesPool.destroy(object);
 }
 
@@ -242,13 +895,19 @@ void PhysicsManager::DestroyPhysicsComponent(CarPhysicsComponent* object)
 void PhysicsManager::BeginContact(b2Contact* contact)
 {
     if (ProcessSensorContact(contact, true))
+    {
+        ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_SensorEvents];
         return;
+    }
 }
 
 void PhysicsManager::EndContact(b2Contact* contact)
 {
     if (ProcessSensorContact(contact, false))
+    {
+        ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_SensorEvents];
         return;
+    }
 }
 
 void PhysicsManager::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
@@ -256,76 +915,67 @@ void PhysicsManager::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
 
-    b2Fixture* fixtureMapSolidBlock = nullptr;
-    b2Fixture* fixturePed = nullptr;
-    b2Fixture* fixtureCar = nullptr;
-    if (fixtureA->GetFilterData().categoryBits == PHYSICS_OBJCAT_MAP_SOLID_BLOCK)
+    // order fixtures by role so each pair is handled once
+    eFixtureRole roleA = gFixtureRoles.GetRole(fixtureA);
+    eFixtureRole roleB = gFixtureRoles.GetRole(fixtureB);
+    if (roleA > roleB)
     {
-        fixtureMapSolidBlock = fixtureA;
-    }
-    if (fixtureB->GetFilterData().categoryBits == PHYSICS_OBJCAT_MAP_SOLID_BLOCK)
-    {
-        fixtureMapSolidBlock = fixtureB;
+        std::swap(fixtureA, fixtureB);
+        std::swap(roleA, roleB);
     }
 
-    if (fixtureA->GetFilterData().categoryBits == PHYSICS_OBJCAT_PED)
-    {
-        fixturePed = fixtureA;
-    }
-    if (fixtureB->GetFilterData().categoryBits == PHYSICS_OBJCAT_PED)
-    {
-        fixturePed = fixtureB;
-    }
-
-    if (fixtureA->GetFilterData().categoryBits == PHYSICS_OBJCAT_CAR)
-    {
-        fixtureCar = fixtureA;
-    }
-    if (fixtureB->GetFilterData().categoryBits == PHYSICS_OBJCAT_CAR)
+    // pedestrian may ignore collisions with some of categories
+    auto ShouldPedCollide = [](b2Fixture* fixturePed, b2Fixture* fixtureOther)
     {
-        fixtureCar = fixtureB;
-    }
+        PedPhysicsComponent* physicsComponent = (PedPhysicsComponent*) fixturePed->GetBody()->GetUserData();
+        debug_assert(physicsComponent);
+        return physicsComponent->ShouldCollideWith(fixtureOther->GetFilterData().categoryBits);
+    };
 
     bool hasCollision = true;
-    for (;;)
+    switch (roleA * eFixtureRole_COUNT + roleB)
     {
-        if (fixtureA->GetFilterData().categoryBits == PHYSICS_OBJCAT_PED &&
-            fixtureB->GetFilterData().categoryBits == PHYSICS_OBJCAT_PED)
-        {
-            PedPhysicsComponent* physicsComponentA = (PedPhysicsComponent*) fixtureA->GetBody()->GetUserData();
-            PedPhysicsComponent* physicsComponentB = (PedPhysicsComponent*) fixtureB->GetBody()->GetUserData();
-            hasCollision = CollidePedVsPed(contact, physicsComponentA, physicsComponentB);
-        }
-
-        if (hasCollision && fixturePed)
+        case eFixtureRole_MapSolidBlock * eFixtureRole_COUNT + eFixtureRole_Ped:
         {
-            PedPhysicsComponent* physicsComponent = (PedPhysicsComponent*) fixturePed->GetBody()->GetUserData();
-            debug_assert(physicsComponent);
+            ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_PreSolvePedVsMap];
 
-            hasCollision = physicsComponent->ShouldCollideWith((fixtureA != fixturePed ? fixtureA : fixtureB)->GetFilterData().categoryBits);
-        }
- 
-        if (hasCollision && fixtureMapSolidBlock && fixturePed)
-        {
-            b2FixtureData_map fxdata = fixtureMapSolidBlock->GetUserData();
-            PhysicsComponent* physicsObject = (PhysicsComponent*) fixturePed->GetBody()->GetUserData();
+            b2FixtureData_map fxdata = fixtureA->GetUserData();
+            PhysicsComponent* physicsObject = (PhysicsComponent*) fixtureB->GetBody()->GetUserData();
             debug_assert(physicsObject);
-            // detect height
-            float height = gGameMap.GetHeightAtPosition(physicsObject->GetPosition());
-            hasCollision = HasCollisionPedestrianVsMap(fxdata.mX, fxdata.mZ, height);
+            hasCollision = ShouldPedCollide(fixtureB, fixtureA) && 
+                HasCollisionPedestrianVsMap(fxdata.mX, fxdata.mZ, physicsObject->mStepMapLayer);
         }
-
-        if (hasCollision && fixtureMapSolidBlock && fixtureCar)
+        break;
+        case eFixtureRole_MapSolidBlock * eFixtureRole_COUNT + eFixtureRole_Car:
         {
-            b2FixtureData_map fxdata = fixtureMapSolidBlock->GetUserData();
-            hasCollision = HasCollisionCarVsMap(contact, fixtureCar, fxdata.mX, fxdata.mZ);
+            ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_PreSolveCarVsMap];
+
+            b2FixtureData_map fxdata = fixtureA->GetUserData();
+            hasCollision = HasCollisionCarVsMap(contact, fixtureB, fxdata.mX, fxdata.mZ);
         }
+        break;
+        case eFixtureRole_Ped * eFixtureRole_COUNT + eFixtureRole_Car:
+            ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_PreSolvePedVsCar];
 
-        if (hasCollision && fixtureCar && fixturePed)
+            hasCollision = ShouldPedCollide(fixtureA, fixtureB) && HasCollisionPedestrianVsCar(contact, fixtureA, fixtureB);
+        break;
+        case eFixtureRole_Ped * eFixtureRole_COUNT + eFixtureRole_Ped:
         {
-            hasCollision = HasCollisionPedestrianVsCar(contact, fixturePed, fixtureCar);
+            ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_PreSolvePedVsPed];
+
+            PedPhysicsComponent* physicsComponentA = (PedPhysicsComponent*) fixtureA->GetBody()->GetUserData();
+            PedPhysicsComponent* physicsComponentB = (PedPhysicsComponent*) fixtureB->GetBody()->GetUserData();
+            hasCollision = CollidePedVsPed(contact, physicsComponentA, physicsComponentB) && ShouldPedCollide(fixtureB, fixtureA);
         }
+        break;
+        default:
+            ++mCurrentStepStats.mCounters[ePhysicsStatsCounter_PreSolveOther];
 
+            // roles are ordered so pedestrian can only be second one here
+            if (roleB == eFixtureRole_Ped)
+            {
+                hasCollision = ShouldPedCollide(fixtureB, fixtureA);
+            }
         break;
     }
 
@@ -339,89 +989,153 @@ void PhysicsManager::PostSolve(b2Contact* contact, const b2ContactImpulse* impul
 void PhysicsManager::FixedStepGravity()
 {
     // cars
-    for (Vehicle* currCar: gGameObjectsManager.mCarsList)
+    mStepCarsArray.clear();
+    for (CarPhysicsComponent* currComponent: mCarsBodiesList)
     {
-        CarPhysicsComponent* physicsComponent = currCar->mPhysicsComponent;
-
-        if (physicsComponent->mWaterContact)
+        if (currComponent->mWaterContact || currComponent->IsSleeping())
             continue;
 
-        glm::vec3 position = physicsComponent->GetPosition();
+        mStepCarsArray.push_back(currComponent);
+    }
 
-        // process falling
-        float newHeight = gGameMap.GetHeightAtPosition(position, false);
+    int numCars = static_cast<int>(mStepCarsArray.size());
+    mStepEventsArray.resize(numCars);
 
-        bool onTheGround = newHeight > (position.y - 0.01f);
-        if (!onTheGround)
+    ParallelFor(numCars, [this](int firstElement, int lastElement)
         {
-            physicsComponent->mHeight -= (PHYSICS_SIMULATION_STEP / 2.0f);
-        }
-        else
-        {
-            physicsComponent->mHeight = newHeight;
-        }
-
-        // handle water contact
-        glm::ivec3 iposition = physicsComponent->GetPosition();
-        BlockStyle* currentTile = gGameMap.GetBlockClamp(iposition.x, iposition.z, iposition.y);
+            for (int icurr = firstElement; icurr < lastElement; ++icurr)
+            {
+                CarPhysicsComponent* physicsComponent = mStepCarsArray[icurr];
+                StepEventsData& eventsData = mStepEventsArray[icurr];
+                eventsData.mEvents = 0;
+
+                glm::vec3 position = physicsComponent->GetPosition();
+
+                // process falling
+                float newHeight = gGameMap.GetHeightAtPosition(position, false);
+
+                bool onTheGround = newHeight > (position.y - 0.01f);
+                if (!onTheGround)
+                {
+                    physicsComponent->mHeight -= (PHYSICS_SIMULATION_STEP / 2.0f);
+                }
+                else
+                {
+                    physicsComponent->mHeight = newHeight;
+                }
+
+                // handle water contact
+                glm::ivec3 iposition = physicsComponent->GetPosition();
+                BlockStyle* currentTile = gGameMap.GetBlockClamp(iposition.x, iposition.z, iposition.y);
+
+                if (currentTile->mGroundType == eGroundType_Water)
+                {
+                    eventsData.mEvents |= eStepEvent_WaterContact;
+                }
+            }
+        });
 
-        if (currentTile->mGroundType == eGroundType_Water)
+    for (int icurr = 0; icurr < numCars; ++icurr)
+    {
+        if (mStepEventsArray[icurr].mEvents & eStepEvent_WaterContact)
         {
-            physicsComponent->HandleWaterContact();
+            mStepCarsArray[icurr]->HandleWaterContact();
         }
     }
 
     // pedestrians
-    for (Pedestrian* currPedestrian: gGameObjectsManager.mPedestriansList)
+    mStepPedsArray.clear();
+    for (PedPhysicsComponent* currComponent: mPedsBodiesList)
     {
-        PedPhysicsComponent* physicsComponent = currPedestrian->mPhysicsComponent;
+        Pedestrian* currPedestrian = currComponent->mReferencePed;
         if (currPedestrian->mCurrentCar)
         {
             glm::vec3 carPosition = currPedestrian->mCurrentCar->mPhysicsComponent->GetPosition();
 
-            physicsComponent->mHeight = carPosition.y;
+            currComponent->mHeight = carPosition.y;
             continue;
         }
 
-        if (physicsComponent->mWaterContact)
+        // kinematic pedestrians take height of map under them while moving, see MoveKinematicPed
+        if (currComponent->mWaterContact || currComponent->IsSleeping() || currComponent->IsKinematic())
             continue;
 
-        glm::vec3 position = physicsComponent->GetPosition();
+        mStepPedsArray.push_back(currComponent);
+    }
 
-        // process fall
-        float newHeight = gGameMap.GetHeightAtPosition(position, false);
+    int numPeds = static_cast<int>(mStepPedsArray.size());
+    mStepEventsArray.resize(numPeds);
 
-        bool onTheGround = newHeight > (position.y - 0.01f);
-        if (physicsComponent->mFalling)
-        {
-            if (onTheGround)
-            {
-                physicsComponent->HandleFallEnd();
-            }
-        }
-        else
+    ParallelFor(numPeds, [this](int firstElement, int lastElement)
         {
-            float distanceToGround = position.y - newHeight;
-            if (distanceToGround > (MAP_BLOCK_LENGTH - 0.01f))
+            for (int icurr = firstElement; icurr < lastElement; ++icurr)
             {
-                physicsComponent->HandleFallBegin(distanceToGround);
+                PedPhysicsComponent* physicsComponent = mStepPedsArray[icurr];
+                StepEventsData& eventsData = mStepEventsArray[icurr];
+                eventsData.mEvents = 0;
+
+                glm::vec3 position = physicsComponent->GetPosition();
+
+                // process fall, state change is applied later
+                float newHeight = gGameMap.GetHeightAtPosition(position, false);
+
+                bool onTheGround = newHeight > (position.y - 0.01f);
+                bool isFalling = physicsComponent->mFalling;
+                if (isFalling)
+                {
+                    if (onTheGround)
+                    {
+                        eventsData.mEvents |= eStepEvent_FallEnd;
+                        isFalling = false;
+                    }
+                }
+                else
+                {
+                    float distanceToGround = position.y - newHeight;
+                    if (distanceToGround > (MAP_BLOCK_LENGTH - 0.01f))
+                    {
+                        eventsData.mEvents |= eStepEvent_FallBegin;
+                        eventsData.mFallDistance = distanceToGround;
+                        isFalling = true;
+                    }
+                }
+
+                if (!onTheGround && isFalling)
+                {
+                    physicsComponent->mHeight -= (PHYSICS_SIMULATION_STEP / 2.0f);
+                }
+                else
+                {
+                    physicsComponent->mHeight = newHeight;
+                }
+
+                // handle water contact
+                glm::ivec3 iposition = physicsComponent->GetPosition();
+                BlockStyle* currentTile = gGameMap.GetBlockClamp(iposition.x, iposition.z, iposition.y);
+
+                if (currentTile->mGroundType == eGroundType_Water)
+                {
+                    eventsData.mEvents |= eStepEvent_WaterContact;
+                }
             }
-        }
+        });
+
+    for (int icurr = 0; icurr < numPeds; ++icurr)
+    {
+        const StepEventsData& eventsData = mStepEventsArray[icurr];
+        if (eventsData.mEvents == 0)
+            continue;
 
-        if (!onTheGround && physicsComponent->mFalling)
+        PedPhysicsComponent* physicsComponent = mStepPedsArray[icurr];
+        if (eventsData.mEvents & eStepEvent_FallEnd)
         {
-            physicsComponent->mHeight -= (PHYSICS_SIMULATION_STEP / 2.0f);
+            physicsComponent->HandleFallEnd();
         }
-        else
+        if (eventsData.mEvents & eStepEvent_FallBegin)
         {
-            physicsComponent->mHeight = newHeight;
+            physicsComponent->HandleFallBegin(eventsData.mFallDistance);
         }
-
-        // handle water contact
-        glm::ivec3 iposition = physicsComponent->GetPosition();
-        BlockStyle* currentTile = gGameMap.GetBlockClamp(iposition.x, iposition.z, iposition.y);
-
-        if (currentTile->mGroundType == eGroundType_Water)
+        if (eventsData.mEvents & eStepEvent_WaterContact)
         {
             physicsComponent->HandleWaterContact();
         }
@@ -435,26 +1149,22 @@ bool PhysicsManager::CollidePedVsPed(b2Contact* contact, PedPhysicsComponent* pe
     return false;
 }
 
-bool PhysicsManager::HasCollisionPedestrianVsMap(int mapx, int mapz, float height) const
+bool PhysicsManager::HasCollisionPedestrianVsMap(int mapx, int mapz, int map_layer) const
 {
-    int map_layer = (int) (height + 0.5f);
-
     // todo: temporary implementation
 
-    BlockStyle* blockData = gGameMap.GetBlockClamp(mapx, mapz, map_layer);
-    return (blockData->mGroundType == eGroundType_Building);
+    return IsMapBuildingBlock(mapx, mapz, map_layer);
 }
 
 bool PhysicsManager::HasCollisionCarVsMap(b2Contact* contact, b2Fixture* fixtureCar, int mapx, int mapz) const
 {
     CarPhysicsComponent* carPhysicsComponent = (CarPhysicsComponent*) fixtureCar->GetBody()->GetUserData();
     debug_assert(carPhysicsComponent);
-    int map_layer = (int) (carPhysicsComponent->mHeight + 0.5f);
+    int map_layer = carPhysicsComponent->mStepMapLayer;
 
     // todo: temporary implementation
 
-    BlockStyle* blockData = gGameMap.GetBlockClamp(mapx, mapz, map_layer);
-    return (blockData->mGroundType == eGroundType_Building);
+    return IsMapBuildingBlock(mapx, mapz, map_layer);
 }
 
 bool PhysicsManager::HasCollisionPedestrianVsCar(b2Contact* contact, b2Fixture* fixturePed, b2Fixture* fixtureCar)
@@ -531,94 +1241,301 @@ bool PhysicsManager::GetContactComponents(b2Contact* contact, PedPhysicsComponen
     return true;
 }
 
-void PhysicsManager::QueryObjectsLinecast(const glm::vec2& pointA, const glm::vec2& pointB, PhysicsLinecastResult& outputResult) const
+// collects cars and pedestrians hit by ray into output buffer
+struct PhysicsLinecastCallback: public b2RayCastCallback
 {
-    outputResult.SetNull();
+public:
+    PhysicsLinecastCallback(PhysicsQueryBuffer<PhysicsLinecastHit>& out)
+        : mOutput(out)
+    {
+    }
+    float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction) override
+    {
+        PhysicsLinecastHit* currHit = nullptr;
+
+        const b2Filter& filterData = fixture->GetFilterData();
+        if (filterData.categoryBits == PHYSICS_OBJCAT_CAR)
+        {
+            currHit = &mOutput.Append();
+            currHit->mCarComponent = (CarPhysicsComponent*) fixture->GetBody()->GetUserData();
+
+        }
+        if (filterData.categoryBits == PHYSICS_OBJCAT_PED)
+        {
+            currHit = &mOutput.Append();
+            currHit->mPedComponent = (PedPhysicsComponent*) fixture->GetBody()->GetUserData();
+        }
+        if (currHit)
+        {
+            currHit->mIntersectionPoint.x = ConvertPhysicsToMap(point.x);
+            currHit->mIntersectionPoint.y = ConvertPhysicsToMap(point.y);
+            currHit->mNormal.x = normal.x;
+            currHit->mNormal.y = normal.y;
+        }
+        return 1.0f;
+    }
+public:
+    PhysicsQueryBuffer<PhysicsLinecastHit>& mOutput;
+};
 
-    struct _raycast_callback: public b2RayCastCallback
+// collects cars and pedestrians within aabbox into output buffer
+struct PhysicsBoxQueryCallback: public b2QueryCallback
+{
+public:
+    PhysicsBoxQueryCallback(PhysicsQueryBuffer<PhysicsQueryElement>& out)
+        : mOutput(out) 
     {
-    public:
-        _raycast_callback(PhysicsLinecastResult& out)
-            : mOutput(out)
+    }
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+        const b2Filter& filterData = fixture->GetFilterData();
+        if (filterData.categoryBits == PHYSICS_OBJCAT_CAR)
         {
+            PhysicsQueryElement& currElement = mOutput.Append();
+            currElement.mCarComponent = (CarPhysicsComponent*) fixture->GetBody()->GetUserData();
         }
-	    float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction) override
+
+        if (filterData.categoryBits == PHYSICS_OBJCAT_PED)
         {
-            if (mOutput.IsFull())
-                return 0.0f;
+            PhysicsQueryElement& currElement = mOutput.Append();
+            currElement.mPedComponent = (PedPhysicsComponent*) fixture->GetBody()->GetUserData();
+        }
+        return true;
+    }
+public:
+    PhysicsQueryBuffer<PhysicsQueryElement>& mOutput;
+};
 
-            PhysicsLinecastHit* currHit = nullptr;
+void PhysicsManager::QueryObjectsLinecast(const glm::vec2& pointA, const glm::vec2& pointB, PhysicsLinecastResult& outputResult)
+{
+    double queryStartTime = gSystem.GetSysSeconds();
 
-            const b2Filter& filterData = fixture->GetFilterData();
-            if (filterData.categoryBits == PHYSICS_OBJCAT_CAR)
-            {
-                currHit = &mOutput.mHits[mOutput.mHitsCount++];
-                currHit->mCarComponent = (CarPhysicsComponent*) fixture->GetBody()->GetUserData();
+    outputResult.SetNull();
 
-            }
-            if (filterData.categoryBits == PHYSICS_OBJCAT_PED)
-            {
-                currHit = &mOutput.mHits[mOutput.mHitsCount++];
-                currHit->mPedComponent = (PedPhysicsComponent*) fixture->GetBody()->GetUserData();
-            }
-            if (currHit)
-            {
-                currHit->mIntersectionPoint.x = ConvertPhysicsToMap(point.x);
-                currHit->mIntersectionPoint.y = ConvertPhysicsToMap(point.y);
-                currHit->mNormal.x = normal.x;
-                currHit->mNormal.y = normal.y;
-            }
-            return 1.0f;
-        }
-    public:
-        PhysicsLinecastResult& mOutput;
-    };
+    PhysicsLinecastCallback raycastCallback {outputResult.mHits};
+    ProcessLinecast(pointA, pointB, raycastCallback);
 
-    _raycast_callback raycast_callback {outputResult};
-    b2Vec2 p1 { pointA.x * PHYSICS_SCALE, pointA.y * PHYSICS_SCALE };
-    b2Vec2 p2 { pointB.x * PHYSICS_SCALE, pointB.y * PHYSICS_SCALE };
-    mPhysicsWorld->RayCast(&raycast_callback, p1, p2);
+    ++mQueriesCounter;
+    mQueriesTimeCounter += (gSystem.GetSysSeconds() - queryStartTime) * 1000.0;
 }
 
-void PhysicsManager::QueryObjectsWithinBox(const glm::vec2& aaboxCenter, const glm::vec2& aabboxExtents, PhysicsQueryResult& outputResult) const
+void PhysicsManager::QueryObjectsWithinBox(const glm::vec2& aaboxCenter, const glm::vec2& aabboxExtents, PhysicsQueryResult& outputResult)
 {
+    double queryStartTime = gSystem.GetSysSeconds();
+
     outputResult.SetNull();
 
-    struct _query_callback: public b2QueryCallback
+    PhysicsBoxQueryCallback queryCallback {outputResult.mElements};
+    ProcessBoxQuery(aaboxCenter, aabboxExtents, queryCallback);
+
+    ++mQueriesCounter;
+    mQueriesTimeCounter += (gSystem.GetSysSeconds() - queryStartTime) * 1000.0;
+}
+
+void PhysicsManager::QueryObjectsLinecast(PhysicsLinecastBatch& batch)
+{
+    double queryStartTime = gSystem.GetSysSeconds();
+
+    batch.mHits.Clear();
+
+    PhysicsLinecastCallback raycastCallback {batch.mHits};
+    for (int icurrQuery = 0, numQueries = batch.mQueries.GetCount(); icurrQuery < numQueries; ++icurrQuery)
+    {
+        PhysicsLinecastQuery& currQuery = batch.mQueries[icurrQuery];
+        currQuery.mFirstHit = batch.mHits.GetCount();
+        ProcessLinecast(currQuery.mPointA, currQuery.mPointB, raycastCallback);
+        currQuery.mHitsCount = batch.mHits.GetCount() - currQuery.mFirstHit;
+    }
+
+    mQueriesCounter += batch.mQueries.GetCount();
+    mQueriesTimeCounter += (gSystem.GetSysSeconds() - queryStartTime) * 1000.0;
+}
+
+void PhysicsManager::QueryObjectsWithinBox(PhysicsQueryBatch& batch)
+{
+    double queryStartTime = gSystem.GetSysSeconds();
+
+    batch.mElements.Clear();
+
+    PhysicsBoxQueryCallback queryCallback {batch.mElements};
+    for (int icurrQuery = 0, numQueries = batch.mQueries.GetCount(); icurrQuery < numQueries; ++icurrQuery)
     {
-    public:
-        _query_callback(PhysicsQueryResult& out)
-            : mOutput(out) 
+        PhysicsBoxQuery& currQuery = batch.mQueries[icurrQuery];
+        currQuery.mFirstElement = batch.mElements.GetCount();
+        ProcessBoxQuery(currQuery.mCenter, currQuery.mExtents, queryCallback);
+        currQuery.mElementsCount = batch.mElements.GetCount() - currQuery.mFirstElement;
+    }
+
+    mQueriesCounter += batch.mQueries.GetCount();
+    mQueriesTimeCounter += (gSystem.GetSysSeconds() - queryStartTime) * 1000.0;
+}
+
+void PhysicsManager::BuildKinematicPedsGrid()
+{
+    mKinematicPedsGridDirty = false;
+
+    const int NumCells = KinematicPedsGridDims * KinematicPedsGridDims;
+    mKinematicPedsCells.assign(NumCells + 1, 0);
+    mKinematicPedsGrid.clear();
+
+    auto GetCellIndex = [](const PedPhysicsComponent* component)
+    {
+        glm::vec3 position = component->GetPosition();
+        return GetKinematicPedsGridCoord(position.z) * KinematicPedsGridDims + GetKinematicPedsGridCoord(position.x);
+    };
+
+    // count pedestrians per cell
+    for (PedPhysicsComponent* currComponent: mPedsBodiesList)
+    {
+        if (currComponent->IsKinematic())
         {
+            ++mKinematicPedsCells[GetCellIndex(currComponent)];
         }
-        bool ReportFixture(b2Fixture* fixture) override
+    }
+
+    // convert counts to cells start indices
+    int numElements = 0;
+    for (int icell = 0; icell < NumCells; ++icell)
+    {
+        int cellCount = mKinematicPedsCells[icell];
+        mKinematicPedsCells[icell] = numElements;
+        numElements += cellCount;
+    }
+    mKinematicPedsCells[NumCells] = numElements;
+    if (numElements == 0)
+        return;
+
+    // fill cells, start indices get advanced to cell ends so shift them back afterwards
+    mKinematicPedsGrid.resize(numElements);
+    for (PedPhysicsComponent* currComponent: mPedsBodiesList)
+    {
+        if (currComponent->IsKinematic())
         {
-            if (mOutput.IsFull())
-                return false;
+            mKinematicPedsGrid[mKinematicPedsCells[GetCellIndex(currComponent)]++] = currComponent;
+        }
+    }
+    for (int icell = NumCells; icell > 0; --icell)
+    {
+        mKinematicPedsCells[icell] = mKinematicPedsCells[icell - 1];
+    }
+    mKinematicPedsCells[0] = 0;
+}
 
-            const b2Filter& filterData = fixture->GetFilterData();
-            if (filterData.categoryBits == PHYSICS_OBJCAT_CAR)
-            {
-                PhysicsQueryElement& currElement = mOutput.mElements[mOutput.mElementsCount++];
-                currElement.mCarComponent = (CarPhysicsComponent*) fixture->GetBody()->GetUserData();
-            }
+void PhysicsManager::GetKinematicPeds(const glm::vec2& areaMin, const glm::vec2& areaMax, PhysicsQueryBuffer<PedPhysicsComponent*>& outputPeds)
+{
+    if (mKinematicPedsGridDirty)
+    {
+        BuildKinematicPedsGrid();
+    }
 
-            if (filterData.categoryBits == PHYSICS_OBJCAT_PED)
-            {
-                PhysicsQueryElement& currElement = mOutput.mElements[mOutput.mElementsCount++];
-                currElement.mPedComponent = (PedPhysicsComponent*) fixture->GetBody()->GetUserData();
-            }
-            return true;
+    if (mKinematicPedsGrid.empty())
+        return;
+
+    const float pedRadius = PHYSICS_PED_BOUNDING_SPHERE_RADIUS;
+    int minCellx = GetKinematicPedsGridCoord(areaMin.x - pedRadius);
+    int minCellz = GetKinematicPedsGridCoord(areaMin.y - pedRadius);
+    int maxCellx = GetKinematicPedsGridCoord(areaMax.x + pedRadius);
+    int maxCellz = GetKinematicPedsGridCoord(areaMax.y + pedRadius);
+    for (int cellz = minCellz; cellz <= maxCellz; ++cellz)
+    {
+        // cells of grid row are contiguous
+        int firstElement = mKinematicPedsCells[cellz * KinematicPedsGridDims + minCellx];
+        int lastElement = mKinematicPedsCells[cellz * KinematicPedsGridDims + maxCellx + 1];
+        for (int icurr = firstElement; icurr < lastElement; ++icurr)
+        {
+            outputPeds.Append() = mKinematicPedsGrid[icurr];
         }
-    public:
-        PhysicsQueryResult& mOutput;
-    };
-    _query_callback query_callback {outputResult};
+    }
+}
+
+void PhysicsManager::ProcessLinecast(const glm::vec2& pointA, const glm::vec2& pointB, PhysicsLinecastCallback& raycastCallback)
+{
+    b2Vec2 p1 { pointA.x * PHYSICS_SCALE, pointA.y * PHYSICS_SCALE };
+    b2Vec2 p2 { pointB.x * PHYSICS_SCALE, pointB.y * PHYSICS_SCALE };
+    mPhysicsWorld->RayCast(&raycastCallback, p1, p2);
 
+    // kinematic pedestrians are not in physics world, test them against line directly and promote on hit
+    glm::vec2 direction = pointB - pointA;
+    float directionLength2 = glm::length2(direction);
+    if (directionLength2 < 0.0001f)
+        return;
+
+    PhysicsQueryBuffer<PedPhysicsComponent*> kinematicPeds;
+    GetKinematicPeds(glm::min(pointA, pointB), glm::max(pointA, pointB), kinematicPeds);
+
+    const float pedRadius = PHYSICS_PED_BOUNDING_SPHERE_RADIUS;
+    for (int icurrPed = 0, numPeds = kinematicPeds.GetCount(); icurrPed < numPeds; ++icurrPed)
+    {
+        PedPhysicsComponent* currComponent = kinematicPeds[icurrPed];
+        if (!currComponent->IsKinematic()) // was promoted by previous query in batch
+            continue;
+
+        glm::vec3 position = currComponent->GetPosition();
+        glm::vec2 center (position.x, position.z);
+
+        // ray vs circle intersection, first intersection along line only,
+        // line that starts inside circle hits it at start point
+        glm::vec2 offset = pointA - center;
+        float c = glm::length2(offset) - pedRadius * pedRadius;
+        float fraction = 0.0f;
+        if (c > 0.0f)
+        {
+            float b = glm::dot(offset, direction);
+            float discriminant = b * b - directionLength2 * c;
+            if (discriminant < 0.0f)
+                continue;
+
+            fraction = (-b - sqrtf(discriminant)) / directionLength2;
+            if (fraction < 0.0f || fraction > 1.0f)
+                continue;
+        }
+
+        PromoteKinematicPed(currComponent);
+
+        PhysicsLinecastHit& currHit = raycastCallback.mOutput.Append();
+        currHit.mPedComponent = currComponent;
+        currHit.mIntersectionPoint = pointA + fraction * direction;
+        if (c > 0.0f)
+        {
+            currHit.mNormal = (currHit.mIntersectionPoint - center) / pedRadius;
+        }
+        else
+        {
+            currHit.mNormal = -direction / sqrtf(directionLength2);
+        }
+    }
+}
+
+void PhysicsManager::ProcessBoxQuery(const glm::vec2& aaboxCenter, const glm::vec2& aabboxExtents, PhysicsBoxQueryCallback& queryCallback)
+{
     b2AABB aabb;
     aabb.lowerBound.x = (aaboxCenter.x - aabboxExtents.x) * PHYSICS_SCALE;
     aabb.lowerBound.y = (aaboxCenter.y - aabboxExtents.y) * PHYSICS_SCALE;
     aabb.upperBound.x = (aaboxCenter.x + aabboxExtents.x) * PHYSICS_SCALE;
     aabb.upperBound.y = (aaboxCenter.y + aabboxExtents.y) * PHYSICS_SCALE;
-    mPhysicsWorld->QueryAABB(&query_callback, aabb);
+    mPhysicsWorld->QueryAABB(&queryCallback, aabb);
+
+    // kinematic pedestrians are not in physics world, test them against box directly and promote on hit
+    PhysicsQueryBuffer<PedPhysicsComponent*> kinematicPeds;
+    GetKinematicPeds(aaboxCenter - aabboxExtents, aaboxCenter + aabboxExtents, kinematicPeds);
+
+    const float pedRadius = PHYSICS_PED_BOUNDING_SPHERE_RADIUS;
+    for (int icurrPed = 0, numPeds = kinematicPeds.GetCount(); icurrPed < numPeds; ++icurrPed)
+    {
+        PedPhysicsComponent* currComponent = kinematicPeds[icurrPed];
+        if (!currComponent->IsKinematic()) // was promoted by previous query in batch
+            continue;
+
+        glm::vec3 position = currComponent->GetPosition();
+        if (fabs(position.x - aaboxCenter.x) > (aabboxExtents.x + pedRadius) ||
+            fabs(position.z - aaboxCenter.y) > (aabboxExtents.y + pedRadius))
+        {
+            continue;
+        }
+
+        PromoteKinematicPed(currComponent);
+
+        PhysicsQueryElement& currElement = queryCallback.mOutput.Append();
+        currElement.mPedComponent = currComponent;
+    }
 }
\ No newline at end of file
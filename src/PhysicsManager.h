@@ -3,10 +3,86 @@
 #include "PhysicsDefs.h"
 #include "GameDefs.h"
 #include "PhysicsComponents.h"
+#include "WorkerThreadPool.h"
+
+// forwards
+struct PhysicsLinecastCallback;
+struct PhysicsBoxQueryCallback;
+
+// adapts amount of physics work done per frame to cpu time budget
+struct PhysicsStepScheduler
+{
+public:
+    PhysicsStepScheduler() = default;
+
+    // get number of simulation steps to run in current frame
+    // @param pendingSteps: Steps required to catch up with accumulated time
+    // @param budgetMs: Frame time budget for physics, zero if unlimited
+    int GetStepsToSimulate(int pendingSteps, float budgetMs) const;
+
+    // push timings of simulation steps done in current frame, solver iterations gets adapted
+    // @param numSteps: Steps simulated in current frame
+    // @param stepsTimeMs: Time spent for steps
+    // @param budgetMs: Frame time budget for physics, zero if unlimited
+    void UpdateStats(int numSteps, double stepsTimeMs, float budgetMs);
+    void Reset();
+
+public:
+    int mVelocityIterations = 4; // current solver iterations
+    int mPositionIterations = 4;
+    float mSmoothedStepTimeMs = 0.0f;
+    int mFramesWithinBudget = 0;
+    int mBudgetOverrunsCount = 0; // frames which exceeded budget
+    int mDroppedStepsCount = 0; // steps never simulated, simulation runs slower than real time
+};
+
+// profiling data of simulation steps, can be summed over multiple steps
+struct PhysicsStepStats
+{
+public:
+    PhysicsStepStats() = default;
+    void SetNull();
+
+    // add values of other stats
+    // @param other: Source stats
+    void Accumulate(const PhysicsStepStats& other);
+
+    // format single line with average values per step for log output
+    // @param outputString: Output string
+    void FormatLogLine(std::string& outputString) const;
+
+    // get number of contacts filtered in PreSolve, all fixture roles
+    long long GetPreSolveCount() const;
+
+public:
+    int mStepsCount = 0;
+    long long mCounters[ePhysicsStatsCounter_COUNT] = {};
+    double mStageTimeMs[ePhysicsStage_COUNT] = {};
+};
 
 // this class manages physics and collision detections for map and objects
 class PhysicsManager final: private b2ContactListener
 {
+public:
+    // public for convenience, should not be modified directly
+    int mMapFixturesCount = 0; // merged map collision rectangles
+    int mMapSolidBlocksCount = 0; // map blocks covered by collision rectangles
+    int mSimulationStepsCount = 0; // simulation steps done in last frame
+    double mSimulationTimeMs = 0.0; // time spent in simulation steps in last frame
+    int mSimulationStepsDropped = 0; // simulation steps dropped in last frame
+    int mInactiveBodiesCount = 0; // bodies outside of activity zones
+    int mSleepingBodiesCount = 0; // bodies which simulation is skipped
+    int mKinematicPedsCount = 0; // pedestrians without physics body
+    int mWorkerThreadsCount = 1; // threads used by per-body passes
+    int mQueriesCount = 0; // linecast and aabbox queries done in last frame
+    double mQueriesTimeMs = 0.0; // time spent in queries in last frame
+
+    PhysicsStepScheduler mStepScheduler;
+
+    PhysicsStepStats mLastStepStats; // profiling data of last simulation step
+    PhysicsStepStats mFrameStats; // profiling data of simulation steps done in last frame
+    PhysicsStepStats mTotalStats; // profiling data of all simulation steps since initialization
+
 public:
     PhysicsManager();
 
@@ -37,17 +113,67 @@ public:
     // @param pointA, pointB: Line of intersect points
     // @param aaboxCenter, aabboxExtents: AABBox area of intersections
     // @param outputResult: Output objects
-    void QueryObjectsLinecast(const glm::vec2& pointA, const glm::vec2& pointB, PhysicsLinecastResult& outputResult) const;
-    void QueryObjectsWithinBox(const glm::vec2& aaboxCenter, const glm::vec2& aabboxExtents, PhysicsQueryResult& outputResult) const;
+    // kinematic pedestrians which get into query are promoted to full physics
+    void QueryObjectsLinecast(const glm::vec2& pointA, const glm::vec2& pointB, PhysicsLinecastResult& outputResult);
+    void QueryObjectsWithinBox(const glm::vec2& aaboxCenter, const glm::vec2& aabboxExtents, PhysicsQueryResult& outputResult);
+
+    // process batch of queries at once, hits of each query are written to shared buffer of batch
+    // @param batch: Queries to process, result ranges are stored within queries
+    void QueryObjectsLinecast(PhysicsLinecastBatch& batch);
+    void QueryObjectsWithinBox(PhysicsQueryBatch& batch);
+
+    // write or read simulation state, used by world snapshots
+    // physics world is recreated on load so all physics components must be destroyed before
+    // @param snapshot: Snapshot data
+    void SaveSnapshot(WorldSnapshot& snapshot) const;
+    bool LoadSnapshot(WorldSnapshot& snapshot);
+
+    // force kinematic pedestrians lookup grid rebuild before next query,
+    // should be called when kinematic pedestrian gets moved outside of simulation step
+    inline void InvalidateKinematicPedsGrid() { mKinematicPedsGridDirty = true; }
+
+    // get simulation time not yet consumed by fixed steps, in seconds
+    inline float GetSimulationTimeAccumulator() const { return mSimulationTimeAccumulator; }
 
 private:
     // create level map body, used internally
     void CreateMapCollisionShape();
 
+    // replace physics world with empty one, map collision fixtures are copied from previous world
+    void RecreatePhysicsWorld();
+
     // apply gravity forces and correct y coord for objects
     void FixedStepGravity();
 
     void ProcessSimulationStep(bool resetPreviousState);
+    void UpdateStepMapContext();
+    // put to sleep bodies outside of activity zones around human characters and wake up approached ones,
+    // pedestrians outside of zones are switched to kinematic tier
+    void UpdateActivityZones();
+
+    // move kinematic pedestrians over map blocks grid
+    void KinematicPedsStep();
+    void MoveKinematicPed(PedPhysicsComponent* component);
+    bool CanKinematicPedMoveTo(const glm::vec3& position, const glm::vec3& targetPosition) const;
+    void PromoteKinematicPed(PedPhysicsComponent* component);
+
+    // kinematic pedestrians are not in physics world broadphase, queries look them up in map grid cells instead
+    void BuildKinematicPedsGrid();
+    // collect kinematic pedestrians from grid cells overlapping area, grid gets rebuilt first if outdated
+    // @param areaMin, areaMax: Area bounds on map
+    // @param outputPeds: Output buffer
+    void GetKinematicPeds(const glm::vec2& areaMin, const glm::vec2& areaMax, PhysicsQueryBuffer<PedPhysicsComponent*>& outputPeds);
+
+    // queries implementation, results are appended to output buffer of callback
+    void ProcessLinecast(const glm::vec2& pointA, const glm::vec2& pointB, PhysicsLinecastCallback& raycastCallback);
+    void ProcessBoxQuery(const glm::vec2& aaboxCenter, const glm::vec2& aabboxExtents, PhysicsBoxQueryCallback& queryCallback);
+
+    // split elements range into contiguous chunks and process them on persistent worker threads,
+    // current thread takes part in processing, returns when all chunks are done
+    // @param numElements: Total elements count
+    // @param rangeFunc: Chunk processing routine, receives first and last (exclusive) element index
+    void ParallelFor(int numElements, const std::function<void(int, int)>& rangeFunc);
+
     void ProcessInterpolation();
 
     // override b2ContactFilter
@@ -57,7 +183,8 @@ private:
 	void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override;
 
     bool CollidePedVsPed(b2Contact* contact, PedPhysicsComponent* pedA, PedPhysicsComponent* pedB);
-    bool HasCollisionPedestrianVsMap(int mapx, int mapz, float height) const;
+    bool HasCollisionPedestrianVsMap(int mapx, int mapz, int map_layer) const;
+    bool IsMapBuildingBlock(int mapx, int mapz, int layer) const;
     bool HasCollisionCarVsMap(b2Contact* contact, b2Fixture* fixtureCar, int mapx, int mapz) const;
     bool HasCollisionPedestrianVsCar(b2Contact* contact, b2Fixture* fixturePed, b2Fixture* fixtureCar);
 
@@ -69,7 +196,36 @@ private:
     b2Body* mMapCollisionShape;
     b2World* mPhysicsWorld;
 
+    // collision lookup grid, building layers bitmask for each map cell
+    std::vector<unsigned char> mMapBuildingLayers;
+
     float mSimulationTimeAccumulator;
+    PhysicsStepStats mCurrentStepStats; // gathered during simulation step
+    int mQueriesCounter = 0;
+    double mQueriesTimeCounter = 0.0;
+
+    // per-body passes data, components are gathered into contiguous arrays each step,
+    // side effects are recorded by worker threads and applied afterwards on current thread
+    enum eStepEvent: unsigned char
+    {
+        eStepEvent_FallBegin = (1 << 0),
+        eStepEvent_FallEnd = (1 << 1),
+        eStepEvent_WaterContact = (1 << 2),
+    };
+    struct StepEventsData
+    {
+        unsigned char mEvents = 0; // see eStepEvent bits
+        float mFallDistance = 0.0f;
+    };
+    std::vector<CarPhysicsComponent*> mStepCarsArray;
+    std::vector<PedPhysicsComponent*> mStepPedsArray;
+    std::vector<StepEventsData> mStepEventsArray;
+    WorkerThreadPool mWorkerThreads; // started once with mWorkerThreadsCount threads
+
+    // kinematic pedestrians sorted by grid cells, rebuilt on first query after simulation step or pedestrian changes
+    std::vector<int> mKinematicPedsCells; // first element index in grid array for each cell, plus end index
+    std::vector<PedPhysicsComponent*> mKinematicPedsGrid;
+    bool mKinematicPedsGridDirty = true;
 
     // physics components pools
     cxx::object_pool<PedPhysicsComponent> mPedsBodiesPool;
@@ -0,0 +1,87 @@
+#include "stdafx.h"
+#include "PhysicsStatsWindow.h"
+#include "imgui.h"
+#include "PhysicsManager.h"
+
+PhysicsStatsWindow gPhysicsStatsWindow;
+
+PhysicsStatsWindow::PhysicsStatsWindow()
+    : DebugWindow("Physics Stats")
+{
+}
+
+void PhysicsStatsWindow::DoUI(Timespan deltaTime)
+{
+    ImGuiWindowFlags wndFlags = ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoBringToFrontOnFocus | 
+        ImGuiWindowFlags_NoNav | ImGuiWindowFlags_AlwaysAutoResize;
+
+    if (!ImGui::Begin(mWindowName, &mWindowShown, wndFlags))
+    {
+        ImGui::End();
+        return;
+    }
+
+    const PhysicsStepStats& lastStepStats = gPhysics.mLastStepStats;
+    const PhysicsStepStats& frameStats = gPhysics.mFrameStats;
+    const PhysicsStepStats& totalStats = gPhysics.mTotalStats;
+    double numTotalSteps = std::max(totalStats.mStepsCount, 1) * 1.0;
+
+    ImGui::Text("Steps in last frame: %d, total: %d", frameStats.mStepsCount, totalStats.mStepsCount);
+    ImGui::Text("Frame time: %.3f ms (budget %.2f ms)", gPhysics.mSimulationTimeMs, gSystem.mConfig.mPhysicsFrameBudgetMs);
+    ImGui::Separator();
+
+    ImGui::Columns(4);
+    ImGui::Text("Stage, ms");
+    ImGui::NextColumn();
+    ImGui::Text("Step");
+    ImGui::NextColumn();
+    ImGui::Text("Frame");
+    ImGui::NextColumn();
+    ImGui::Text("Avg per step");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (int istage = 0; istage < ePhysicsStage_COUNT; ++istage)
+    {
+        ImGui::Text("%s", cxx::enum_to_string(static_cast<ePhysicsStage>(istage)));
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", lastStepStats.mStageTimeMs[istage]);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", frameStats.mStageTimeMs[istage]);
+        ImGui::NextColumn();
+        ImGui::Text("%.3f", totalStats.mStageTimeMs[istage] / numTotalSteps);
+        ImGui::NextColumn();
+    }
+    ImGui::Separator();
+
+    ImGui::Text("Counter");
+    ImGui::NextColumn();
+    ImGui::Text("Step");
+    ImGui::NextColumn();
+    ImGui::Text("Frame");
+    ImGui::NextColumn();
+    ImGui::Text("Avg per step");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (int icounter = 0; icounter < ePhysicsStatsCounter_COUNT; ++icounter)
+    {
+        ImGui::Text("%s", cxx::enum_to_string(static_cast<ePhysicsStatsCounter>(icounter)));
+        ImGui::NextColumn();
+        ImGui::Text("%lld", lastStepStats.mCounters[icounter]);
+        ImGui::NextColumn();
+        ImGui::Text("%lld", frameStats.mCounters[icounter]);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", totalStats.mCounters[icounter] / numTotalSteps);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::Separator();
+
+    ImGui::Text("Bodies inactive: %d, sleeping: %d, kinematic peds: %d", 
+        gPhysics.mInactiveBodiesCount, 
+        gPhysics.mSleepingBodiesCount, 
+        gPhysics.mKinematicPedsCount);
+    ImGui::Text("Queries in last frame: %d (%.3f ms)", gPhysics.mQueriesCount, gPhysics.mQueriesTimeMs);
+    ImGui::End();
+}
\ No newline at end of file
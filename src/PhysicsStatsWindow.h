@@ -0,0 +1,17 @@
+#pragma once
+
+#include "DebugWindow.h"
+
+// shows simulation steps profiling data gathered by physics manager
+class PhysicsStatsWindow: public DebugWindow
+{
+public:
+    PhysicsStatsWindow();
+
+private:
+    // process window state
+    // @param deltaTime: Time since last frame
+    void DoUI(Timespan deltaTime) override;
+};
+
+extern PhysicsStatsWindow gPhysicsStatsWindow;
\ No newline at end of file
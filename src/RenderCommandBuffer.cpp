@@ -0,0 +1,199 @@
+#include "stdafx.h"
+#include "RenderCommandBuffer.h"
+#include "RenderProgram.h"
+#include "TrimeshBuffer.h"
+
+void RenderCommandBuffer::Clear()
+{
+    mCommands.clear();
+    mVertexFormats.clear();
+    mRenderStates.clear();
+    mCameraMatrices.clear();
+    mUploadData.clear();
+}
+
+void RenderCommandBuffer::Execute()
+{
+    for (const RenderCommand& currCommand: mCommands)
+    {
+        switch (currCommand.mCommandType)
+        {
+            case eRenderCommand_ActivateProgram:
+                static_cast<RenderProgram*>(currCommand.mResource)->Activate();
+            break;
+            case eRenderCommand_DeactivateProgram:
+                static_cast<RenderProgram*>(currCommand.mResource)->Deactivate();
+            break;
+            case eRenderCommand_UploadCameraMatrices:
+            {
+                const CameraMatrices& matrices = mCameraMatrices[currCommand.mParams[0]];
+                static_cast<RenderProgram*>(currCommand.mResource)->UploadCameraTransformMatrices(matrices.mViewMatrix, 
+                    matrices.mProjectionMatrix, 
+                    matrices.mViewProjectionMatrix, 
+                    matrices.mPosition);
+            }
+            break;
+            case eRenderCommand_SetRenderStates:
+                gGraphicsDevice.SetRenderStates(mRenderStates[currCommand.mParams[0]]);
+            break;
+            case eRenderCommand_BindVertexBuffer:
+                gGraphicsDevice.BindVertexBuffer(static_cast<GpuBuffer*>(currCommand.mResource), mVertexFormats[currCommand.mParams[0]]);
+            break;
+            case eRenderCommand_BindIndexBuffer:
+                gGraphicsDevice.BindIndexBuffer(static_cast<GpuBuffer*>(currCommand.mResource));
+            break;
+            case eRenderCommand_BindBufferTexture:
+                gGraphicsDevice.BindTexture(currCommand.mTextureUnit, static_cast<GpuBufferTexture*>(currCommand.mResource));
+            break;
+            case eRenderCommand_BindTexture2D:
+                gGraphicsDevice.BindTexture(currCommand.mTextureUnit, static_cast<GpuTexture2D*>(currCommand.mResource));
+            break;
+            case eRenderCommand_BindTextureArray2D:
+                gGraphicsDevice.BindTexture(currCommand.mTextureUnit, static_cast<GpuTextureArray2D*>(currCommand.mResource));
+            break;
+            case eRenderCommand_UploadTrimesh:
+            {
+                TrimeshBuffer* trimeshBuffer = static_cast<TrimeshBuffer*>(currCommand.mResource);
+                trimeshBuffer->SetVertices(currCommand.mParams[1], mUploadData.data() + currCommand.mParams[0]);
+                trimeshBuffer->SetIndices(currCommand.mParams[3], mUploadData.data() + currCommand.mParams[2]);
+            }
+            break;
+            case eRenderCommand_BindTrimesh:
+                static_cast<TrimeshBuffer*>(currCommand.mResource)->Bind(mVertexFormats[currCommand.mParams[0]]);
+            break;
+            case eRenderCommand_DrawIndexed:
+                gGraphicsDevice.RenderIndexedPrimitives(static_cast<ePrimitiveType>(currCommand.mParams[0]), 
+                    static_cast<eIndicesType>(currCommand.mParams[1]), 
+                    currCommand.mParams[2], 
+                    currCommand.mParams[3]);
+            break;
+            default:
+                debug_assert(false);
+            break;
+        }
+    }
+}
+
+void RenderCommandBuffer::ActivateProgram(RenderProgram* program)
+{
+    debug_assert(program);
+    AddCommand(eRenderCommand_ActivateProgram, program);
+}
+
+void RenderCommandBuffer::DeactivateProgram(RenderProgram* program)
+{
+    debug_assert(program);
+    AddCommand(eRenderCommand_DeactivateProgram, program);
+}
+
+void RenderCommandBuffer::UploadCameraTransformMatrices(RenderProgram* program, const GameCamera& gameCamera)
+{
+    debug_assert(program);
+    RenderCommand& command = AddCommand(eRenderCommand_UploadCameraMatrices, program);
+    command.mParams[0] = mCameraMatrices.size();
+
+    // camera may change before commands gets replayed so matrices are copied
+    mCameraMatrices.emplace_back();
+    CameraMatrices& matrices = mCameraMatrices.back();
+    matrices.mViewMatrix = gameCamera.mViewMatrix;
+    matrices.mProjectionMatrix = gameCamera.mProjectionMatrix;
+    matrices.mViewProjectionMatrix = gameCamera.mViewProjectionMatrix;
+    matrices.mPosition = gameCamera.mPosition;
+}
+
+void RenderCommandBuffer::SetRenderStates(const RenderStates& renderStates)
+{
+    RenderCommand& command = AddCommand(eRenderCommand_SetRenderStates, nullptr);
+    command.mParams[0] = mRenderStates.size();
+    mRenderStates.push_back(renderStates);
+}
+
+void RenderCommandBuffer::BindVertexBuffer(GpuBuffer* sourceBuffer, const VertexFormat& streamDefinition)
+{
+    RenderCommand& command = AddCommand(eRenderCommand_BindVertexBuffer, sourceBuffer);
+    command.mParams[0] = mVertexFormats.size();
+    mVertexFormats.push_back(streamDefinition);
+}
+
+void RenderCommandBuffer::BindIndexBuffer(GpuBuffer* sourceBuffer)
+{
+    AddCommand(eRenderCommand_BindIndexBuffer, sourceBuffer);
+}
+
+void RenderCommandBuffer::BindTexture(eTextureUnit textureUnit, GpuBufferTexture* texture)
+{
+    debug_assert(textureUnit < eTextureUnit_COUNT);
+    RenderCommand& command = AddCommand(eRenderCommand_BindBufferTexture, texture);
+    command.mTextureUnit = textureUnit;
+}
+
+void RenderCommandBuffer::BindTexture(eTextureUnit textureUnit, GpuTexture2D* texture)
+{
+    debug_assert(textureUnit < eTextureUnit_COUNT);
+    RenderCommand& command = AddCommand(eRenderCommand_BindTexture2D, texture);
+    command.mTextureUnit = textureUnit;
+}
+
+void RenderCommandBuffer::BindTexture(eTextureUnit textureUnit, GpuTextureArray2D* texture)
+{
+    debug_assert(textureUnit < eTextureUnit_COUNT);
+    RenderCommand& command = AddCommand(eRenderCommand_BindTextureArray2D, texture);
+    command.mTextureUnit = textureUnit;
+}
+
+void RenderCommandBuffer::RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesType indicesType, unsigned int offset, unsigned int numIndices)
+{
+    RenderCommand& command = AddCommand(eRenderCommand_DrawIndexed, nullptr);
+    command.mParams[0] = primitive;
+    command.mParams[1] = indicesType;
+    command.mParams[2] = offset;
+    command.mParams[3] = numIndices;
+}
+
+void RenderCommandBuffer::UploadTrimesh(TrimeshBuffer* trimeshBuffer, unsigned int verticesLength, const void* verticesData, 
+    unsigned int indicesLength, const void* indicesData)
+{
+    debug_assert(trimeshBuffer);
+    debug_assert(verticesLength && verticesData);
+    debug_assert(indicesLength && indicesData);
+
+    unsigned int verticesOffset = AddUploadData(verticesLength, verticesData);
+    unsigned int indicesOffset = AddUploadData(indicesLength, indicesData);
+
+    RenderCommand& command = AddCommand(eRenderCommand_UploadTrimesh, trimeshBuffer);
+    command.mParams[0] = verticesOffset;
+    command.mParams[1] = verticesLength;
+    command.mParams[2] = indicesOffset;
+    command.mParams[3] = indicesLength;
+}
+
+void RenderCommandBuffer::BindTrimesh(TrimeshBuffer* trimeshBuffer, const VertexFormat& vertexFormat)
+{
+    debug_assert(trimeshBuffer);
+    RenderCommand& command = AddCommand(eRenderCommand_BindTrimesh, trimeshBuffer);
+    command.mParams[0] = mVertexFormats.size();
+    mVertexFormats.push_back(vertexFormat);
+}
+
+RenderCommandBuffer::RenderCommand& RenderCommandBuffer::AddCommand(eRenderCommand commandType, void* resource)
+{
+    mCommands.emplace_back();
+
+    RenderCommand& command = mCommands.back();
+    command.mCommandType = commandType;
+    command.mTextureUnit = eTextureUnit_0;
+    command.mResource = resource;
+    command.mParams[0] = 0;
+    command.mParams[1] = 0;
+    command.mParams[2] = 0;
+    command.mParams[3] = 0;
+    return command;
+}
+
+unsigned int RenderCommandBuffer::AddUploadData(unsigned int dataLength, const void* dataSource)
+{
+    unsigned int dataOffset = mUploadData.size();
+    mUploadData.resize(dataOffset + dataLength);
+    ::memcpy(mUploadData.data() + dataOffset, dataSource, dataLength);
+    return dataOffset;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "GraphicsDefs.h"
+
+class RenderProgram;
+class TrimeshBuffer;
+class GameCamera;
+
+// defines type of recorded render command
+enum eRenderCommand
+{
+    eRenderCommand_ActivateProgram,
+    eRenderCommand_DeactivateProgram,
+    eRenderCommand_UploadCameraMatrices,
+    eRenderCommand_SetRenderStates,
+    eRenderCommand_BindVertexBuffer,
+    eRenderCommand_BindIndexBuffer,
+    eRenderCommand_BindBufferTexture,
+    eRenderCommand_BindTexture2D,
+    eRenderCommand_BindTextureArray2D,
+    eRenderCommand_UploadTrimesh,
+    eRenderCommand_BindTrimesh,
+    eRenderCommand_DrawIndexed,
+};
+
+// Render command buffer holds compact list of bind, state, upload and draw commands
+// Commands can be recorded on any thread since graphics device is not touched, then buffer gets replayed on graphics thread
+// Upload data is copied on recording so source memory can be reused right away
+
+class RenderCommandBuffer final: public cxx::noncopyable
+{
+public:
+    // discard all recorded commands, allocated memory is kept for next recording
+    void Clear();
+
+    // replay recorded commands in same order, must be called on graphics thread
+    void Execute();
+
+    // record commands, params are same as in graphics device and render program
+    void ActivateProgram(RenderProgram* program);
+    void DeactivateProgram(RenderProgram* program);
+    void UploadCameraTransformMatrices(RenderProgram* program, const GameCamera& gameCamera);
+    void SetRenderStates(const RenderStates& renderStates);
+    void BindVertexBuffer(GpuBuffer* sourceBuffer, const VertexFormat& streamDefinition);
+    void BindIndexBuffer(GpuBuffer* sourceBuffer);
+    void BindTexture(eTextureUnit textureUnit, GpuBufferTexture* texture);
+    void BindTexture(eTextureUnit textureUnit, GpuTexture2D* texture);
+    void BindTexture(eTextureUnit textureUnit, GpuTextureArray2D* texture);
+    void RenderIndexedPrimitives(ePrimitiveType primitive, eIndicesType indicesType, unsigned int offset, unsigned int numIndices);
+
+    // record geometry upload to trimesh buffer
+    // @param trimeshBuffer: Target buffer
+    // @param verticesLength, verticesData: Vertex data to copy
+    // @param indicesLength, indicesData: Index data to copy
+    void UploadTrimesh(TrimeshBuffer* trimeshBuffer, unsigned int verticesLength, const void* verticesData, 
+        unsigned int indicesLength, const void* indicesData);
+
+    // record trimesh buffer binding
+    // @param trimeshBuffer: Source buffer
+    // @param vertexFormat: Layout
+    void BindTrimesh(TrimeshBuffer* trimeshBuffer, const VertexFormat& vertexFormat);
+
+    // get number of commands recorded since last clear
+    inline int GetCommandsCount() const { return mCommands.size(); }
+
+private:
+    struct RenderCommand
+    {
+        eRenderCommand mCommandType;
+        eTextureUnit mTextureUnit; // bind texture commands only
+        void* mResource; // program, buffer, texture or trimesh depending on command type
+        unsigned int mParams[4]; // depends on command type
+    };
+
+    struct CameraMatrices
+    {
+        glm::mat4 mViewMatrix;
+        glm::mat4 mProjectionMatrix;
+        glm::mat4 mViewProjectionMatrix;
+        glm::vec3 mPosition;
+    };
+
+    RenderCommand& AddCommand(eRenderCommand commandType, void* resource);
+    unsigned int AddUploadData(unsigned int dataLength, const void* dataSource);
+
+private:
+    std::vector<RenderCommand> mCommands;
+    // commands arguments that does not fit in command itself
+    std::vector<VertexFormat> mVertexFormats;
+    std::vector<RenderStates> mRenderStates;
+    std::vector<CameraMatrices> mCameraMatrices;
+    std::vector<unsigned char> mUploadData;
+};
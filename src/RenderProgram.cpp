@@ -2,6 +2,34 @@
 #include "RenderProgram.h"
 #include "GpuProgram.h"
 
+// shader cache file header, binary data follows it
+struct ShaderCacheFileHeader
+{
+    unsigned int mMagic;
+    unsigned int mVersion;
+    unsigned long long mSourceHash; // source code and driver string hash
+    unsigned int mBinaryFormat;
+    unsigned int mBinaryLength;
+};
+
+const unsigned int ShaderCacheMagic = 0x48534743; // CGSH
+const unsigned int ShaderCacheVersion = 1;
+
+// FNV-1a
+static unsigned long long ComputeShaderCacheHash(const std::string& sourceCode, const std::string& driverString)
+{
+    unsigned long long hashValue = 14695981039346656037ULL;
+    for (const std::string* currString: { &sourceCode, &driverString })
+    {
+        for (unsigned char currChar: *currString)
+        {
+            hashValue ^= currChar;
+            hashValue *= 1099511628211ULL;
+        }
+    }
+    return hashValue;
+}
+
 RenderProgram::RenderProgram(const char* srcFileName)
     : mSourceFileName(srcFileName)
 {
@@ -40,11 +68,22 @@ bool RenderProgram::Reinitialize()
         return false;
     }
 
-    bool isCompiled = mGpuProgram->CompileSourceCode(shaderSourceCode.c_str());
+    mLoadedFromCache = LoadProgramBinaryCache(shaderSourceCode);
+
+    bool isCompiled = mLoadedFromCache;
+    if (!isCompiled)
+    {
+        isCompiled = mGpuProgram->CompileSourceCode(shaderSourceCode.c_str());
+        if (isCompiled)
+        {
+            SaveProgramBinaryCache(shaderSourceCode);
+        }
+    }
+
     if (isCompiled)
     {
         InitUniformParameters();
-        gConsole.LogMessage(eLogMessage_Info, "Render program loaded %s", mSourceFileName);
+        gConsole.LogMessage(eLogMessage_Info, "Render program loaded %s%s", mSourceFileName, mLoadedFromCache ? " (cached)" : "");
     }
     else
     {
@@ -53,6 +92,70 @@ bool RenderProgram::Reinitialize()
     return isCompiled;
 }
 
+bool RenderProgram::LoadProgramBinaryCache(const std::string& sourceCode)
+{
+    if (!gGraphicsDevice.mCaps.mFeatures[eGraphicsFeature_ProgramBinary])
+        return false;
+
+    std::ifstream fileStream {GetProgramBinaryCachePath(), std::ios::in | std::ios::binary};
+    if (!fileStream.is_open())
+        return false;
+
+    ShaderCacheFileHeader header;
+    if (!fileStream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+
+    // outdated binary, either source code or driver was changed
+    if (header.mMagic != ShaderCacheMagic || header.mVersion != ShaderCacheVersion || header.mBinaryLength == 0 ||
+        header.mSourceHash != ComputeShaderCacheHash(sourceCode, gGraphicsDevice.mCaps.mDriverString))
+    {
+        return false;
+    }
+
+    std::vector<unsigned char> binaryData(header.mBinaryLength);
+    if (!fileStream.read(reinterpret_cast<char*>(binaryData.data()), header.mBinaryLength))
+        return false;
+
+    if (!mGpuProgram->LoadProgramBinary(header.mBinaryFormat, binaryData.data(), header.mBinaryLength))
+    {
+        gConsole.LogMessage(eLogMessage_Debug, "Shader cache binary rejected by driver %s", mSourceFileName);
+        return false;
+    }
+    return true;
+}
+
+void RenderProgram::SaveProgramBinaryCache(const std::string& sourceCode)
+{
+    ShaderCacheFileHeader header;
+    std::vector<unsigned char> binaryData;
+    if (!mGpuProgram->GetProgramBinary(header.mBinaryFormat, binaryData))
+        return;
+
+    header.mMagic = ShaderCacheMagic;
+    header.mVersion = ShaderCacheVersion;
+    header.mSourceHash = ComputeShaderCacheHash(sourceCode, gGraphicsDevice.mCaps.mDriverString);
+    header.mBinaryLength = binaryData.size();
+
+    std::string cachePath = GetProgramBinaryCachePath();
+    if (!cxx::ensure_path_exists(cxx::get_parent_directory(cachePath)))
+        return;
+
+    std::ofstream fileStream {cachePath, std::ios::out | std::ios::binary | std::ios::trunc};
+    if (!fileStream.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Debug, "Cannot write shader cache file %s", cachePath.c_str());
+        return;
+    }
+
+    fileStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fileStream.write(reinterpret_cast<const char*>(binaryData.data()), binaryData.size());
+}
+
+std::string RenderProgram::GetProgramBinaryCachePath() const
+{
+    return gFiles.mWorkingDirectoryPath + "/shadercache/" + cxx::get_name_without_extension(mSourceFileName) + ".bin";
+}
+
 void RenderProgram::Deinit()
 {
     if (mGpuProgram == nullptr)
@@ -95,6 +198,12 @@ void RenderProgram::Deactivate()
 }
 
 void RenderProgram::UploadCameraTransformMatrices(GameCamera& gameCamera)
+{
+    UploadCameraTransformMatrices(gameCamera.mViewMatrix, gameCamera.mProjectionMatrix, gameCamera.mViewProjectionMatrix, gameCamera.mPosition);
+}
+
+void RenderProgram::UploadCameraTransformMatrices(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, 
+    const glm::mat4& viewProjectionMatrix, const glm::vec3& cameraPosition)
 {
     bool isInited = IsProgramInited();
     if (isInited)
@@ -105,10 +214,10 @@ void RenderProgram::UploadCameraTransformMatrices(GameCamera& gameCamera)
                 mGpuProgram->SetUniform(uniform_id, matrix_reference); \
             }
 
-        SET_UNIFORM(eRenderUniform_ViewMatrix, gameCamera.mViewMatrix);
-        SET_UNIFORM(eRenderUniform_ProjectionMatrix, gameCamera.mProjectionMatrix);
-        SET_UNIFORM(eRenderUniform_ViewProjectionMatrix, gameCamera.mViewProjectionMatrix);
-        SET_UNIFORM(eRenderUniform_CameraPosition, gameCamera.mPosition);
+        SET_UNIFORM(eRenderUniform_ViewMatrix, viewMatrix);
+        SET_UNIFORM(eRenderUniform_ProjectionMatrix, projectionMatrix);
+        SET_UNIFORM(eRenderUniform_ViewProjectionMatrix, viewProjectionMatrix);
+        SET_UNIFORM(eRenderUniform_CameraPosition, cameraPosition);
 
         #undef SET_UNIFORM
     }
@@ -10,6 +10,7 @@ public:
 
     // public for convenience, should not be modified directly
     GpuProgram* mGpuProgram = nullptr;
+    bool mLoadedFromCache = false; // program binary was taken from shader cache on last load
 
 public:
     // @param srcFileName: File name of shader source, should be static string
@@ -33,8 +34,16 @@ public:
     // the matrices stored in game camera class, make sure compute them first
     void UploadCameraTransformMatrices(GameCamera& gameCamera);
     void UploadCameraTransformMatrices(GameCamera2D& gameCamera);
+    void UploadCameraTransformMatrices(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, 
+        const glm::mat4& viewProjectionMatrix, const glm::vec3& cameraPosition);
 
 protected:
+    // shader cache routines, binary is keyed by source code and graphics driver
+    // @param sourceCode: Shader source code
+    bool LoadProgramBinaryCache(const std::string& sourceCode);
+    void SaveProgramBinaryCache(const std::string& sourceCode);
+    std::string GetProgramBinaryCachePath() const;
+
     // overridable
     virtual void InitUniformParameters()
     {
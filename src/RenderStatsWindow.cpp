@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "RenderStatsWindow.h"
+#include "imgui.h"
+#include "RenderingManager.h"
+
+RenderStatsWindow gRenderStatsWindow;
+
+RenderStatsWindow::RenderStatsWindow()
+    : DebugWindow("Render Stats")
+{
+}
+
+void RenderStatsWindow::DoUI(Timespan deltaTime)
+{
+    ImGuiWindowFlags wndFlags = ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoBringToFrontOnFocus | 
+        ImGuiWindowFlags_NoNav | ImGuiWindowFlags_AlwaysAutoResize;
+
+    if (!ImGui::Begin(mWindowName, &mWindowShown, wndFlags))
+    {
+        ImGui::End();
+        return;
+    }
+
+    const RenderStats& renderStats = gRenderManager.mRenderStats;
+    ImGui::Text("Rolling values over last %d frames", (int) RenderStats::FramesWindow);
+    ImGui::Separator();
+
+    ImGui::Columns(5);
+    ImGui::Text("Counter");
+    ImGui::NextColumn();
+    ImGui::Text("Frame");
+    ImGui::NextColumn();
+    ImGui::Text("Min");
+    ImGui::NextColumn();
+    ImGui::Text("Avg");
+    ImGui::NextColumn();
+    ImGui::Text("Max");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (int icounter = 0; icounter < eRenderStatsCounter_COUNT; ++icounter)
+    {
+        const RenderStats::Counter& currCounter = renderStats.mCounters[icounter];
+        ImGui::Text("%s", cxx::enum_to_string(static_cast<eRenderStatsCounter>(icounter)));
+        ImGui::NextColumn();
+        ImGui::Text("%d", currCounter.mFrameValue);
+        ImGui::NextColumn();
+        ImGui::Text("%d", currCounter.mMin);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", currCounter.mAverage);
+        ImGui::NextColumn();
+        ImGui::Text("%d", currCounter.mMax);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+    ImGui::Separator();
+
+    const DynamicResolution& dynamicResolution = gRenderManager.mDynamicResolution;
+    if (gSystem.mConfig.mFrameTimeTargetMs > 0.0f)
+    {
+        ImGui::Text("Resolution scale: %.2f (frame %.2f ms, gpu %.2f ms, target %.2f ms)", 
+            dynamicResolution.mScale, 
+            dynamicResolution.mSmoothedFrameTimeMs, 
+            dynamicResolution.mSmoothedGpuTimeMs, 
+            gSystem.mConfig.mFrameTimeTargetMs);
+    }
+    else
+    {
+        ImGui::Text("Dynamic resolution disabled");
+    }
+    ImGui::Separator();
+
+    ImGui::Checkbox("Print to log periodically", &gRenderManager.mRenderStatsLogEnabled);
+    ImGui::End();
+}
\ No newline at end of file
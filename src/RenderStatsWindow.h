@@ -0,0 +1,17 @@
+#pragma once
+
+#include "DebugWindow.h"
+
+// shows rendering statistics gathered by render manager
+class RenderStatsWindow: public DebugWindow
+{
+public:
+    RenderStatsWindow();
+
+private:
+    // process window state
+    // @param deltaTime: Time since last frame
+    void DoUI(Timespan deltaTime) override;
+};
+
+extern RenderStatsWindow gRenderStatsWindow;
\ No newline at end of file
@@ -2,12 +2,133 @@
 #include "RenderingManager.h"
 #include "GpuTexture2D.h"
 #include "GpuProgram.h"
+#include "GpuRenderTarget.h"
 #include "SpriteManager.h"
 #include "RenderView.h"
 #include "GameCheatsWindow.h"
+#include "FrameCapture.h"
 
 RenderingManager gRenderManager;
 
+const double RenderStatsLogIntervalSeconds = 10.0;
+
+// dynamic resolution tuning
+const float DynamicResolutionSmoothing = 0.1f; // weight of last frame in smoothed timings
+const float DynamicResolutionScaleStep = 0.05f;
+const float DynamicResolutionUpscaleHeadroom = 0.85f; // scale up only if frame fits into this part of budget
+const int DynamicResolutionChangeIntervalFrames = 15; // frames to wait for timings to settle after change
+
+//////////////////////////////////////////////////////////////////////////
+
+void RenderStats::AddFrame(const GraphicsDeviceStats& deviceStats, int spritesCacheMisses)
+{
+    int frameValues[eRenderStatsCounter_COUNT];
+    frameValues[eRenderStatsCounter_DrawCalls] = deviceStats.mDrawCalls;
+    frameValues[eRenderStatsCounter_Primitives] = deviceStats.mPrimitivesCount;
+    frameValues[eRenderStatsCounter_TextureBinds] = deviceStats.mTextureBinds;
+    frameValues[eRenderStatsCounter_BufferBytesUploaded] = deviceStats.mBufferBytesUploaded;
+    frameValues[eRenderStatsCounter_TextureBytesUploaded] = deviceStats.mTextureBytesUploaded;
+    frameValues[eRenderStatsCounter_SpritesCacheMisses] = spritesCacheMisses;
+
+    int sampleIndex = mFramesCount % FramesWindow;
+    ++mFramesCount;
+
+    int samplesCount = std::min(mFramesCount, (int) FramesWindow);
+    for (int icounter = 0; icounter < eRenderStatsCounter_COUNT; ++icounter)
+    {
+        Counter& currCounter = mCounters[icounter];
+        currCounter.mFrameValue = frameValues[icounter];
+        currCounter.mSamples[sampleIndex] = frameValues[icounter];
+
+        currCounter.mMin = currCounter.mSamples[0];
+        currCounter.mMax = currCounter.mSamples[0];
+        long long samplesSum = 0;
+        for (int isample = 0; isample < samplesCount; ++isample)
+        {
+            currCounter.mMin = std::min(currCounter.mMin, currCounter.mSamples[isample]);
+            currCounter.mMax = std::max(currCounter.mMax, currCounter.mSamples[isample]);
+            samplesSum += currCounter.mSamples[isample];
+        }
+        currCounter.mAverage = static_cast<float>(samplesSum) / samplesCount;
+    }
+}
+
+void RenderStats::FormatLogLine(std::string& outputString) const
+{
+    outputString = "Render stats (min/avg/max):";
+
+    cxx::string_buffer_128 counterString;
+    for (int icounter = 0; icounter < eRenderStatsCounter_COUNT; ++icounter)
+    {
+        const Counter& currCounter = mCounters[icounter];
+        counterString.printf(" %s %d/%.1f/%d;", cxx::enum_to_string(static_cast<eRenderStatsCounter>(icounter)), 
+            currCounter.mMin, currCounter.mAverage, currCounter.mMax);
+        outputString += counterString.c_str();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void DynamicResolution::Reset()
+{
+    mScale = 1.0f;
+    mSmoothedFrameTimeMs = 0.0f;
+    mSmoothedGpuTimeMs = 0.0f;
+    mFramesSinceChange = 0;
+}
+
+void DynamicResolution::Update(float frameTimeMs, float gpuTimeMs, float targetTimeMs, float minScale)
+{
+    if (mSmoothedFrameTimeMs == 0.0f)
+    {
+        mSmoothedFrameTimeMs = frameTimeMs;
+        mSmoothedGpuTimeMs = gpuTimeMs;
+    }
+    mSmoothedFrameTimeMs += (frameTimeMs - mSmoothedFrameTimeMs) * DynamicResolutionSmoothing;
+    mSmoothedGpuTimeMs += (gpuTimeMs - mSmoothedGpuTimeMs) * DynamicResolutionSmoothing;
+
+    if (++mFramesSinceChange < DynamicResolutionChangeIntervalFrames)
+        return;
+
+    const bool gpuTimeKnown = mSmoothedGpuTimeMs > 0.0f;
+
+    float newScale = mScale;
+    if (mSmoothedFrameTimeMs > targetTimeMs)
+    {
+        // lower resolution will not help if frame is cpu bound
+        if (gpuTimeKnown && mSmoothedGpuTimeMs < targetTimeMs * 0.5f)
+            return;
+
+        newScale = std::max(minScale, mScale - DynamicResolutionScaleStep);
+    }
+    else if (mSmoothedFrameTimeMs < targetTimeMs * DynamicResolutionUpscaleHeadroom)
+    {
+        newScale = std::min(1.0f, mScale + DynamicResolutionScaleStep);
+
+        // gpu cost grows with pixels count, make sure it still fits the budget
+        float pixelsRatio = (newScale * newScale) / (mScale * mScale);
+        if (gpuTimeKnown && mSmoothedGpuTimeMs * pixelsRatio > targetTimeMs * DynamicResolutionUpscaleHeadroom)
+            return;
+    }
+
+    if (newScale != mScale)
+    {
+        mScale = newScale;
+        mFramesSinceChange = 0;
+    }
+}
+
+Rect2D DynamicResolution::GetScaledRect(const Rect2D& sourceRect) const
+{
+    int x0 = static_cast<int>(sourceRect.x * mScale + 0.5f);
+    int y0 = static_cast<int>(sourceRect.y * mScale + 0.5f);
+    int x1 = static_cast<int>((sourceRect.x + sourceRect.w) * mScale + 0.5f);
+    int y1 = static_cast<int>((sourceRect.y + sourceRect.h) * mScale + 0.5f);
+    return Rect2D(x0, y0, x1 - x0, y1 - y0);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 RenderingManager::RenderingManager()
     : mDefaultTexColorProgram("shaders/texture_color.glsl")
     , mGuiTexColorProgram("shaders/gui.glsl")
@@ -39,6 +160,13 @@ bool RenderingManager::Initialize()
 
 void RenderingManager::Deinit()
 {
+    if (mSceneRenderTarget)
+    {
+        gGraphicsDevice.DestroyRenderTarget(mSceneRenderTarget);
+        mSceneRenderTarget = nullptr;
+    }
+
+    mDynamicResolution.Reset();
     mActiveRenderViews.clear();
     mDebugRenderer.Deinit();
     mMapRenderer.Deinit();
@@ -49,15 +177,51 @@ void RenderingManager::Deinit()
 
 void RenderingManager::RenderFrame()
 {
+    double stageStartTime = gSystem.GetSysSeconds();
+    auto EndRenderStage = [this, &stageStartTime](eRenderStage renderStage)
+    {
+        double currentTime = gSystem.GetSysSeconds();
+        mRenderStageTimeMs[renderStage] = (currentTime - stageStartTime) * 1000.0;
+        stageStartTime = currentTime;
+    };
+
+    UpdateDynamicResolution(stageStartTime);
+
+    // 3d views are rendered into scaled down target when out of frame time budget
+    Rect2D viewportRectangle = gGraphicsDevice.mViewportRect;
+    bool scaledRendering = (mDynamicResolution.mScale < 1.0f) && PrepareSceneRenderTarget(viewportRectangle);
+    if (scaledRendering)
+    {
+        gGraphicsDevice.BindRenderTarget(mSceneRenderTarget);
+    }
+
     gGraphicsDevice.ClearScreen();
     gSpriteManager.RenderFrameBegin();
     mMapRenderer.RenderFrameBegin();
 
-    Rect2D viewportRectangle = gGraphicsDevice.mViewportRect;
+    // setup all views cameras first, extraction depends on their frustums
     for (RenderView* currRenderview: mActiveRenderViews)
     {
+        currRenderview->mCamera.ComputeMatricesAndFrustum();
+    }
+    EndRenderStage(eRenderStage_Prepare);
+
+    mMapRenderer.ExtractFrameObjects(mActiveRenderViews);
+    EndRenderStage(eRenderStage_Extraction);
+
+    mMapRenderer.RecordRenderViews(mActiveRenderViews);
+    EndRenderStage(eRenderStage_Recording);
+
+    // submit recorded views
+    for (int iview = 0, NumViews = mActiveRenderViews.size(); iview < NumViews; ++iview)
+    {
+        RenderView* currRenderview = mActiveRenderViews[iview];
         currRenderview->DrawFrameBegin();
-        mMapRenderer.RenderFrame(currRenderview);
+        if (scaledRendering)
+        {
+            gGraphicsDevice.SetViewportRect(mDynamicResolution.GetScaledRect(currRenderview->mCamera.mViewportRect));
+        }
+        mMapRenderer.RenderFrame(iview);
 
         // draw debug info for first human view only
         if (currRenderview == mActiveRenderViews[0] && gGameCheatsWindow.mEnableDebugDraw)
@@ -69,7 +233,17 @@ void RenderingManager::RenderFrame()
     }
     gGraphicsDevice.SetViewportRect(viewportRectangle);
 
+    // upscale views to screen, ui goes on top at native resolution
+    if (scaledRendering)
+    {
+        gGraphicsDevice.BindRenderTarget(nullptr);
+        gGraphicsDevice.ClearScreen();
+        gGraphicsDevice.BlitRenderTarget(mSceneRenderTarget, mDynamicResolution.GetScaledRect(viewportRectangle), viewportRectangle);
+    }
+    EndRenderStage(eRenderStage_Submission);
+
     gUiManager.RenderFrame();
+    EndRenderStage(eRenderStage_UI);
 
     for (RenderView* currRenderview: mActiveRenderViews)
     {
@@ -77,7 +251,80 @@ void RenderingManager::RenderFrame()
     }
     mMapRenderer.RenderFrameEnd();
     gSpriteManager.RenderFrameEnd();
+
+    // back buffer content is undefined after present,
+    // readback is timed separately by frame capture and excluded from present stage
+    if (gFrameCapture.IsFramePixelsRequested())
+    {
+        double readbackStartTime = gSystem.GetSysSeconds();
+        gFrameCapture.ReadFramePixels();
+        stageStartTime += gSystem.GetSysSeconds() - readbackStartTime;
+    }
     gGraphicsDevice.Present();
+    EndRenderStage(eRenderStage_Present);
+
+    UpdateRenderStats();
+}
+
+void RenderingManager::UpdateDynamicResolution(double frameStartTime)
+{
+    double frameTimeMs = (frameStartTime - mPrevFrameStartTime) * 1000.0;
+    mPrevFrameStartTime = frameStartTime;
+
+    float targetTimeMs = gSystem.mConfig.mFrameTimeTargetMs;
+    if (targetTimeMs <= 0.0f)
+    {
+        mDynamicResolution.mScale = 1.0f;
+        return;
+    }
+
+    // skip stalls like loading
+    const double MaxFrameTimeMs = 250.0;
+    if (frameTimeMs > MaxFrameTimeMs)
+        return;
+
+    float minScale = glm::clamp(gSystem.mConfig.mMinResolutionScale, 0.1f, 1.0f);
+    mDynamicResolution.Update(static_cast<float>(frameTimeMs), gGraphicsDevice.mGpuFrameTimeMs, targetTimeMs, minScale);
+}
+
+bool RenderingManager::PrepareSceneRenderTarget(const Rect2D& screenRect)
+{
+    if (mSceneRenderTarget && mSceneRenderTarget->mSize.x == screenRect.w && mSceneRenderTarget->mSize.y == screenRect.h)
+        return true;
+
+    // allocated at native resolution once, scaled views use part of it
+    if (mSceneRenderTarget == nullptr)
+    {
+        mSceneRenderTarget = gGraphicsDevice.CreateRenderTarget();
+        if (mSceneRenderTarget == nullptr)
+            return false;
+    }
+
+    if (!mSceneRenderTarget->Setup(screenRect.w, screenRect.h))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot setup scene render target, dynamic resolution disabled");
+        gSystem.mConfig.mFrameTimeTargetMs = 0.0f;
+        return false;
+    }
+    return true;
+}
+
+void RenderingManager::UpdateRenderStats()
+{
+    mRenderStats.AddFrame(gGraphicsDevice.mFrameStats, gSpriteManager.mSpritesCacheMissesCount);
+
+    if (!mRenderStatsLogEnabled)
+        return;
+
+    double currentTime = gSystem.GetSysSeconds();
+    if (currentTime - mRenderStatsLogTime < RenderStatsLogIntervalSeconds)
+        return;
+
+    mRenderStatsLogTime = currentTime;
+
+    std::string logLine;
+    mRenderStats.FormatLogLine(logLine);
+    gConsole.LogMessage(eLogMessage_Debug, "%s", logLine.c_str());
 }
 
 void RenderingManager::FreeRenderPrograms()
@@ -91,12 +338,26 @@ void RenderingManager::FreeRenderPrograms()
 
 bool RenderingManager::InitRenderPrograms()
 {
-    mDefaultTexColorProgram.Initialize();
-    mGuiTexColorProgram.Initialize();
-    mCityMeshProgram.Initialize(); 
-    mSpritesProgram.Initialize();
-    mDebugProgram.Initialize();
+    double startTime = gSystem.GetSysSeconds();
+
+    RenderProgram* renderPrograms[] = 
+    {
+        &mDefaultTexColorProgram, &mGuiTexColorProgram, &mCityMeshProgram, &mSpritesProgram, &mDebugProgram
+    };
+
+    int cachedProgramsCount = 0;
+    for (RenderProgram* currProgram: renderPrograms)
+    {
+        currProgram->Initialize();
+        if (currProgram->mLoadedFromCache)
+        {
+            ++cachedProgramsCount;
+        }
+    }
 
+    double loadingTimeMs = (gSystem.GetSysSeconds() - startTime) * 1000.0;
+    gConsole.LogMessage(eLogMessage_Info, "Render programs loaded in %.2f ms (%d of %d from shader cache)", 
+        loadingTimeMs, cachedProgramsCount, CountOf(renderPrograms));
     return true;
 }
 
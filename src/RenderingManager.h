@@ -7,6 +7,90 @@
 
 class RenderView;
 
+// render counters gathered every frame
+enum eRenderStatsCounter
+{
+    eRenderStatsCounter_DrawCalls,
+    eRenderStatsCounter_Primitives,
+    eRenderStatsCounter_TextureBinds,
+    eRenderStatsCounter_BufferBytesUploaded,
+    eRenderStatsCounter_TextureBytesUploaded,
+    eRenderStatsCounter_SpritesCacheMisses,
+    eRenderStatsCounter_COUNT
+};
+
+decl_enum_strings(eRenderStatsCounter);
+
+// render frame stages measured on cpu side
+enum eRenderStage
+{
+    eRenderStage_Prepare, // clear screen and cameras setup
+    eRenderStage_Extraction,
+    eRenderStage_Recording,
+    eRenderStage_Submission, // map views and debug draw
+    eRenderStage_UI,
+    eRenderStage_Present,
+    eRenderStage_COUNT
+};
+
+decl_enum_strings(eRenderStage);
+
+// rendering statistics with rolling min/avg/max values over last frames
+struct RenderStats
+{
+public:
+    enum { FramesWindow = 120 };
+
+    RenderStats() = default;
+
+    // push counters of last frame and update rolling values
+    // @param deviceStats: Graphics device counters of last frame
+    // @param spritesCacheMisses: Sprite cache misses of last frame
+    void AddFrame(const GraphicsDeviceStats& deviceStats, int spritesCacheMisses);
+
+    // format single line with all counters for log output
+    // @param outputString: Output string
+    void FormatLogLine(std::string& outputString) const;
+
+public:
+    struct Counter
+    {
+        int mFrameValue = 0; // last frame
+        int mMin = 0;
+        int mMax = 0;
+        float mAverage = 0.0f;
+        int mSamples[FramesWindow] = {};
+    };
+    Counter mCounters[eRenderStatsCounter_COUNT];
+    int mFramesCount = 0; // total frames, rolling window is filled when counter reaches FramesWindow
+};
+
+// chooses resolution scale of 3d views to keep frame time within budget, 
+// decisions are made on smoothed cpu frame time and gpu frame time when available
+struct DynamicResolution
+{
+public:
+    DynamicResolution() = default;
+
+    // push timings of last frame and update scale
+    // @param frameTimeMs: Time between frames
+    // @param gpuTimeMs: Gpu time of frame, zero if unknown
+    // @param targetTimeMs: Frame time budget
+    // @param minScale: Lowest allowed scale
+    void Update(float frameTimeMs, float gpuTimeMs, float targetTimeMs, float minScale);
+    void Reset();
+
+    // get rectangle in scaled render target
+    // @param sourceRect: Rectangle at native resolution
+    Rect2D GetScaledRect(const Rect2D& sourceRect) const;
+
+public:
+    float mScale = 1.0f; // linear scale of views dimensions
+    float mSmoothedFrameTimeMs = 0.0f;
+    float mSmoothedGpuTimeMs = 0.0f;
+    int mFramesSinceChange = 0;
+};
+
 // master render system, it is intended to manage rendering pipeline of the game
 class RenderingManager final: public cxx::noncopyable
 {
@@ -19,6 +103,11 @@ public:
 
     MapRenderer mMapRenderer;
 
+    RenderStats mRenderStats;
+    bool mRenderStatsLogEnabled = true; // periodically print render stats to log
+    double mRenderStageTimeMs[eRenderStage_COUNT] = {}; // cpu time of each stage in last frame
+    DynamicResolution mDynamicResolution;
+
     std::vector<RenderView*> mActiveRenderViews;
 
 public:
@@ -46,8 +135,15 @@ private:
     bool InitRenderPrograms();
     void FreeRenderPrograms();
 
+    void UpdateRenderStats();
+    void UpdateDynamicResolution(double frameStartTime);
+    bool PrepareSceneRenderTarget(const Rect2D& screenRect);
+
 private:
     DebugRenderer mDebugRenderer;
+    GpuRenderTarget* mSceneRenderTarget = nullptr; // 3d views are rendered here when resolution is scaled
+    double mPrevFrameStartTime = 0.0;
+    double mRenderStatsLogTime = 0.0; // last time stats were printed
 };
 
 extern RenderingManager gRenderManager;
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "RenderingManager.h"
 #include "SpriteManager.h"
 #include "RenderView.h"
+#include "RenderCommandBuffer.h"
 
 const unsigned int NumVerticesPerSprite = 4;
 const unsigned int NumIndicesPerSprite = 6;
@@ -46,7 +47,18 @@ void SpriteBatch::Flush()
     {
         SortSpritesList();
         GenerateSpritesBatches();
-        RenderSpritesBatches();
+        RenderSpritesBatches();
+    }
+    Clear();
+}
+
+void SpriteBatch::Flush(RenderCommandBuffer& commandBuffer)
+{
+    if (!mSpritesList.empty())
+    {
+        SortSpritesList();
+        GenerateSpritesBatches();
+        RecordSpritesBatches(commandBuffer);
     }
     Clear();
 }
@@ -170,6 +182,22 @@ void SpriteBatch::RenderSpritesBatches()
     }
 }
 
+void SpriteBatch::RecordSpritesBatches(RenderCommandBuffer& commandBuffer)
+{
+    commandBuffer.UploadTrimesh(&mTrimeshBuffer, 
+        Sizeof_SpriteVertex3D * mDrawVertices.size(), mDrawVertices.data(), 
+        Sizeof_DrawIndex * mDrawIndices.size(), mDrawIndices.data());
+    commandBuffer.BindTrimesh(&mTrimeshBuffer, SpriteVertex3D_Format());
+
+    for (const DrawSpriteBatch& currBatch: mBatchesList)
+    {
+        commandBuffer.BindTexture(eTextureUnit_0, currBatch.mSpriteTexture);
+
+        unsigned int idxBufferOffset = Sizeof_DrawIndex * currBatch.mFirstIndex;
+        commandBuffer.RenderIndexedPrimitives(ePrimitiveType_Triangles, eIndicesType_i32, idxBufferOffset, currBatch.mIndexCount);
+    }
+}
+
 void SpriteBatch::BeginBatch(DepthAxis depthAxis)
 {
     Clear();
@@ -4,6 +4,8 @@
 #include "TrimeshBuffer.h"
 #include "Sprite2D.h"
 
+class RenderCommandBuffer;
+
 // defines renderer class for 2d sprites
 class SpriteBatch final: public cxx::noncopyable
 {
@@ -20,6 +22,10 @@ public:
     // render all batched sprites
     void Flush();
 
+    // record render commands for all batched sprites instead of immediate drawing
+    // @param commandBuffer: Target command buffer
+    void Flush(RenderCommandBuffer& commandBuffer);
+
     // discard all batched sprites
     void Clear();
 
@@ -27,10 +33,14 @@ public:
     // @param sourceSprite: Source sprite data
     void DrawSprite(const Sprite2D& sourceSprite);
 
+    // get all sprites added since batch begin
+    inline const std::vector<Sprite2D>& GetSprites() const { return mSpritesList; }
+
 private:
     void SortSpritesList();
     void GenerateSpritesBatches();
     void RenderSpritesBatches();
+    void RecordSpritesBatches(RenderCommandBuffer& commandBuffer);
 
 private:
     // single batch of drawing sprites
@@ -277,7 +277,7 @@ void SpriteManager::InitPalettesTable()
 
 void SpriteManager::RenderFrameBegin()
 {
-
+    mSpritesCacheMissesCount = 0;
 }
 
 void SpriteManager::RenderFrameEnd()
@@ -554,6 +554,7 @@ void SpriteManager::GetSpriteTexture(GameObjectID objectID, int spriteIndex, int
                 return;
             }
             currElement.mSpriteDeltaBits = deltaBits;
+            ++mSpritesCacheMissesCount;
 
             // upload changes
             PixelsArray pixels;
@@ -576,6 +577,8 @@ void SpriteManager::GetSpriteTexture(GameObjectID objectID, int spriteIndex, int
     }
     
     // cache miss
+    ++mSpritesCacheMissesCount;
+
     Size2D dimensions;
     dimensions.x = cxx::get_next_pot(spriteStyle.mWidth);
     dimensions.y = cxx::get_next_pot(spriteStyle.mHeight);
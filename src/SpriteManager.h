@@ -22,6 +22,8 @@ public:
     // all default objects bitmaps (with no deltas applied) are stored in single 2d texture
     Spritesheet mObjectsSpritesheet;
 
+    int mSpritesCacheMissesCount = 0; // per frame, sprites with deltas that had to be generated and uploaded
+
 public:
     // preload sprite textures for current level
     bool InitLevelSprites();
@@ -4,6 +4,9 @@
 #include "RenderingManager.h"
 #include "MemoryManager.h"
 #include "CarnageGame.h"
+#include "PhysicsManager.h"
+#include "FrameCapture.h"
+#include "WorldStateHash.h"
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -24,6 +27,13 @@ SysConfig::SysConfig(int screenSizex, int screenSizey, bool fullscreen, bool vsy
 void SysConfig::SetDefaultParams()
 {
     mOpenGLCoreProfile = true;
+    mOffscreenRendering = false;
+    mOpenGLOSMesaContext = false;
+    mFrameTimeTargetMs = 0.0f;
+    mMinResolutionScale = 0.5f;
+    mPhysicsThreadsCount = 0;
+    mPhysicsSingleBodyVehicles = false;
+    mPhysicsFrameBudgetMs = 0.0f;
     mEnableFrameHeapAllocator = true;
     mShowImguiDemoWindow = false;
 
@@ -53,6 +63,15 @@ void SysStartupParameters::SetNull()
     mDebugMapName.clear();
     mGtaDataLocation.clear();
     mPlayersCount = 0;
+    mBenchmarkFrames = 0;
+    mFrameCaptureScript.clear();
+    mOffscreen = false;
+    mPhysicsThreadsCount = 0;
+    mBenchmarkCars = 0;
+    mBenchmarkPedestrians = 0;
+    mStateHashLog.clear();
+    mStateHashCompare[0].clear();
+    mStateHashCompare[1].clear();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -89,12 +108,36 @@ void System::Execute(const SysStartupParameters& sysStartupParams)
             deltaTime = MaxFrameDelta;
         }
 
+        // captured frames must not depend on machine speed
+        if (gFrameCapture.IsCaptureActive())
+        {
+            deltaTime = gFrameCapture.mFrameDelta;
+        }
+
+        // same for hashed simulation
+        if (gWorldStateHashLog.IsLogActive())
+        {
+            deltaTime = gWorldStateHashLog.mFrameDelta;
+        }
+
         gMemoryManager.FlushFrameHeapMemory();
 
-        // order in which subsystems gets updated is significant
-        gUiManager.UpdateFrame(deltaTime);
-        gCarnageGame.UpdateFrame(deltaTime);
+        double updateStartTime = GetSysSeconds();
+
+        // order in which subsystems gets updated is significant
+        gUiManager.UpdateFrame(deltaTime);
+        gCarnageGame.UpdateFrame(deltaTime);
+        gFrameCapture.UpdateFrame();
+
+        double renderStartTime = GetSysSeconds();
         gRenderManager.RenderFrame();
+        gFrameCapture.ProcessFrame();
+
+        if (mStartupParams.mBenchmarkFrames > 0)
+        {
+            double renderEndTime = GetSysSeconds();
+            ProcessBenchmarkFrame(renderStartTime - updateStartTime, renderEndTime - renderStartTime);
+        }
         previousFrameTimestamp = currentTimestamp;
         if (mIgnoreInputs) // ingore inputs at very first frame
         {
@@ -120,8 +163,33 @@ void System::Initialize()
         Terminate();
     }
 
+    // compare logs of two previous runs, game itself is not required
+    if (!mStartupParams.mStateHashCompare[0].empty())
+    {
+        bool isIdentical = WorldStateHashLog::CompareLogFiles(mStartupParams.mStateHashCompare[0].c_str(), 
+            mStartupParams.mStateHashCompare[1].c_str());
+        Deinit();
+        exit(isIdentical ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
     LoadConfiguration();
 
+    if (mStartupParams.mOffscreen)
+    {
+        mConfig.mOffscreenRendering = true;
+    }
+
+    if (mStartupParams.mPhysicsThreadsCount > 0)
+    {
+        mConfig.mPhysicsThreadsCount = mStartupParams.mPhysicsThreadsCount;
+    }
+
+    // amount of physics work per frame must not depend on machine speed
+    if (!mStartupParams.mStateHashLog.empty() || !mStartupParams.mFrameCaptureScript.empty())
+    {
+        mConfig.mPhysicsFrameBudgetMs = 0.0f;
+    }
+
     if (!gFiles.SetupGtaDataLocation())
     {
         gConsole.LogMessage(eLogMessage_Error, "Set valid gta gamedata location via sys config param 'gta_gamedata_location'");
@@ -157,6 +225,24 @@ void System::Initialize()
         gConsole.LogMessage(eLogMessage_Error, "Cannot initialize game");
         Terminate();
     }
+
+    if (!mStartupParams.mFrameCaptureScript.empty())
+    {
+        if (!gFrameCapture.Initialize(mStartupParams.mFrameCaptureScript.c_str()))
+        {
+            gConsole.LogMessage(eLogMessage_Error, "Cannot initialize frame capture");
+            Terminate();
+        }
+    }
+
+    if (!mStartupParams.mStateHashLog.empty())
+    {
+        if (!gWorldStateHashLog.Initialize(mStartupParams.mStateHashLog.c_str()))
+        {
+            gConsole.LogMessage(eLogMessage_Error, "Cannot initialize world state hash log");
+            Terminate();
+        }
+    }
     mQuitRequested = false;
 }
 
@@ -164,6 +250,8 @@ void System::Deinit()
 {
     gConsole.LogMessage(eLogMessage_Info, "System shutdown");
 
+    gFrameCapture.Deinit();
+    gWorldStateHashLog.Deinit();
     gCarnageGame.Deinit();
     gUiManager.Deinit();
     gRenderManager.Deinit();
@@ -249,6 +337,11 @@ long System::GetSysMilliseconds() const
     return static_cast<long>(totalSeconds * 1000.0);
 }
 
+double System::GetSysSeconds() const
+{
+    return ::glfwGetTime();
+}
+
 bool System::LoadConfiguration()
 {
     mConfig.SetDefaultParams();
@@ -283,6 +376,16 @@ bool System::LoadConfiguration()
         bool hardware_cursor = screenConfig.get_child("hardware_cursor").get_value_boolean();
 
         mConfig.SetParams(screen_sizex, screen_sizey, fullscreen_mode, vsync_mode);
+        mConfig.mOffscreenRendering = screenConfig.get_child("offscreen").get_value_boolean();
+        mConfig.mOpenGLOSMesaContext = screenConfig.get_child("osmesa_context").get_value_boolean();
+        if (cxx::config_node frameTimeTarget = screenConfig.get_child("frame_time_target_ms"))
+        {
+            mConfig.mFrameTimeTargetMs = frameTimeTarget.get_value_float();
+        }
+        if (cxx::config_node minResolutionScale = screenConfig.get_child("min_resolution_scale"))
+        {
+            mConfig.mMinResolutionScale = minResolutionScale.get_value_float();
+        }
     }
 
     // gta1 data files location
@@ -292,6 +395,17 @@ bool System::LoadConfiguration()
         gFiles.mGTADataDirectoryPath = gta_data_root;
     }
 
+    // physics
+    if (cxx::config_node physicsConfig = configDocument.get_root_node().get_child("physics"))
+    {
+        mConfig.mPhysicsThreadsCount = physicsConfig.get_child("threads").get_value_integer();
+        mConfig.mPhysicsSingleBodyVehicles = physicsConfig.get_child("single_body_vehicles").get_value_boolean();
+        if (cxx::config_node frameBudget = physicsConfig.get_child("frame_budget_ms"))
+        {
+            mConfig.mPhysicsFrameBudgetMs = frameBudget.get_value_float();
+        }
+    }
+
     // memory
     if (cxx::config_node memConfig = configDocument.get_root_node().get_child("memory"))
     {
@@ -311,3 +425,68 @@ bool System::SaveConfiguration()
     // todo
     return true;
 }
+
+void System::ProcessBenchmarkFrame(double updateSeconds, double renderSeconds)
+{
+    ++mBenchmarkFramesCounter;
+    mBenchmarkUpdateSeconds += updateSeconds;
+    mBenchmarkRenderSeconds += renderSeconds;
+    mBenchmarkExtractionMs += gRenderManager.mMapRenderer.mRenderStats.mExtractionTimeMs;
+    mBenchmarkSpritesDrawn += gRenderManager.mMapRenderer.mRenderStats.mSpritesDrawnCount;
+    mBenchmarkPhysicsMs += gPhysics.mSimulationTimeMs;
+    mBenchmarkPhysicsSteps += gPhysics.mSimulationStepsCount;
+    mBenchmarkPhysicsContacts += gPhysics.mFrameStats.GetPreSolveCount();
+    mBenchmarkPhysicsQueries += gPhysics.mQueriesCount;
+    mBenchmarkPhysicsQueriesMs += gPhysics.mQueriesTimeMs;
+    mBenchmarkPedestriansMs += gGameObjectsManager.mPedestriansUpdateTimeMs;
+
+    if (mBenchmarkFramesCounter < mStartupParams.mBenchmarkFrames)
+        return;
+
+    double numFrames = mBenchmarkFramesCounter * 1.0;
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: %d frames, %d players, %d cars, %d pedestrians", 
+        mBenchmarkFramesCounter, 
+        gCarnageGame.mNumPlayers, 
+        gGameObjectsManager.mCarsList.size(), 
+        gGameObjectsManager.mPedestriansList.size());
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: update %.3f ms, render %.3f ms (extraction %.3f ms), sprites drawn %.1f per frame",
+        (mBenchmarkUpdateSeconds * 1000.0) / numFrames,
+        (mBenchmarkRenderSeconds * 1000.0) / numFrames,
+        mBenchmarkExtractionMs / numFrames,
+        mBenchmarkSpritesDrawn / numFrames);
+    int numPedestrians = gGameObjectsManager.mPedestriansList.size();
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: pedestrians update %.3f ms per frame, %.3f us per pedestrian",
+        mBenchmarkPedestriansMs / numFrames,
+        (numPedestrians > 0) ? (mBenchmarkPedestriansMs * 1000.0 / numFrames / numPedestrians) : 0.0);
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: physics %.3f ms per frame, %.3f ms per step, %d map fixtures, %d threads",
+        mBenchmarkPhysicsMs / numFrames,
+        (mBenchmarkPhysicsSteps > 0) ? (mBenchmarkPhysicsMs / mBenchmarkPhysicsSteps) : 0.0,
+        gPhysics.mMapFixturesCount,
+        gPhysics.mWorkerThreadsCount);
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: physics budget %.2f ms, %d overruns, %d steps dropped, solver iterations %d/%d",
+        mConfig.mPhysicsFrameBudgetMs,
+        gPhysics.mStepScheduler.mBudgetOverrunsCount,
+        gPhysics.mStepScheduler.mDroppedStepsCount,
+        gPhysics.mStepScheduler.mVelocityIterations,
+        gPhysics.mStepScheduler.mPositionIterations);
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: vehicle model %s",
+        mConfig.mPhysicsSingleBodyVehicles ? "single body" : "wheel bodies");
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: bodies %d inactive, %d sleeping of %d total, %d kinematic pedestrians",
+        gPhysics.mInactiveBodiesCount,
+        gPhysics.mSleepingBodiesCount,
+        (int) (gGameObjectsManager.mCarsList.size() + gGameObjectsManager.mPedestriansList.size()),
+        gPhysics.mKinematicPedsCount);
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: contacts %.1f per frame, %.0f per second of physics time",
+        mBenchmarkPhysicsContacts / numFrames,
+        (mBenchmarkPhysicsMs > 0.0) ? (mBenchmarkPhysicsContacts * 1000.0 / mBenchmarkPhysicsMs) : 0.0);
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: queries %.1f per frame, %.0f per second of query time, %.0f per second of update time",
+        mBenchmarkPhysicsQueries / numFrames,
+        (mBenchmarkPhysicsQueriesMs > 0.0) ? (mBenchmarkPhysicsQueries * 1000.0 / mBenchmarkPhysicsQueriesMs) : 0.0,
+        (mBenchmarkUpdateSeconds > 0.0) ? (mBenchmarkPhysicsQueries / mBenchmarkUpdateSeconds) : 0.0);
+
+    std::string physicsStatsLine;
+    gPhysics.mTotalStats.FormatLogLine(physicsStatsLine);
+    gConsole.LogMessage(eLogMessage_Info, "Benchmark: %s", physicsStatsLine.c_str());
+
+    QuitRequest();
+}
@@ -29,7 +29,15 @@ public:
     bool mFullscreen = false; // enable full screen mode
     bool mEnableVSync = false; // enable vertical synchronization
     bool mOpenGLCoreProfile = true;
+    bool mOffscreenRendering = false; // render to hidden framebuffer, window is never shown
+    bool mOpenGLOSMesaContext = false; // software context through osmesa, for machines without gpu
     float mScreenAspectRatio = 1.0f;
+    float mFrameTimeTargetMs = 0.0f; // lower 3d views resolution when frame time exceeds target, zero to disable
+    float mMinResolutionScale = 0.5f; // lowest dynamic resolution scale
+    // physics settings
+    int mPhysicsThreadsCount = 0; // threads used by per-body physics passes, zero to use hardware concurrency
+    bool mPhysicsSingleBodyVehicles = false; // simulate cars as single chassis body without wheel bodies and joints
+    float mPhysicsFrameBudgetMs = 0.0f; // physics cpu time per frame, solver gets cheaper when exceeded, zero to disable
     // memory settings
     bool mEnableFrameHeapAllocator = true;
     // debug settings
@@ -49,6 +57,14 @@ public:
     cxx::string_buffer_16 mDebugMapName; // startup map name
     cxx::string_buffer_256 mGtaDataLocation; // force gta data location
     int mPlayersCount = 0;
+    int mBenchmarkFrames = 0; // run specified number of frames, log average timings and quit
+    cxx::string_buffer_256 mFrameCaptureScript; // run frame capture script and quit
+    bool mOffscreen = false; // force offscreen rendering
+    int mPhysicsThreadsCount = 0; // force physics threads count, zero to use config value
+    int mBenchmarkCars = 0; // spawn specified number of cars around first player
+    int mBenchmarkPedestrians = 0; // spawn specified number of walking pedestrians around first player
+    cxx::string_buffer_256 mStateHashLog; // write world state hash of every game tick to file, uses fixed time step
+    cxx::string_buffer_256 mStateHashCompare[2]; // compare two world state hash logs and quit
 };
 
 // Common system specific stuff collected in System class
@@ -81,6 +97,9 @@ public:
     // Get milliseconds since system started
     long GetSysMilliseconds() const;
 
+    // Get seconds since system started, high precision, intended for profiling
+    double GetSysSeconds() const;
+
 private:
     void Initialize();
     void Deinit();
@@ -89,9 +108,25 @@ private:
     bool LoadConfiguration();
     bool SaveConfiguration();
 
+    // Accumulate frame timings in benchmark mode, quits when done
+    void ProcessBenchmarkFrame(double updateSeconds, double renderSeconds);
+
 private:
     bool mQuitRequested;
     bool mIgnoreInputs;
+
+    // benchmark mode stats
+    int mBenchmarkFramesCounter = 0;
+    double mBenchmarkUpdateSeconds = 0.0;
+    double mBenchmarkRenderSeconds = 0.0;
+    double mBenchmarkExtractionMs = 0.0;
+    long long mBenchmarkSpritesDrawn = 0;
+    double mBenchmarkPhysicsMs = 0.0;
+    long long mBenchmarkPhysicsSteps = 0;
+    long long mBenchmarkPhysicsContacts = 0;
+    long long mBenchmarkPhysicsQueries = 0;
+    double mBenchmarkPhysicsQueriesMs = 0.0;
+    double mBenchmarkPedestriansMs = 0.0;
 };
 
 extern System gSystem;
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "RenderingManager.h"
 #include "SpriteManager.h"
 #include "Pedestrian.h"
+#include "GameObjectsManager.h"
+#include "WorldSnapshot.h"
 
 Vehicle::Vehicle(GameObjectID id) : GameObject(eGameObjectType_Car, id)
     , mPhysicsComponent()
@@ -54,6 +56,9 @@ void Vehicle::UpdateFrame(Timespan deltaTime)
     UpdateDeltaAnimations(deltaTime);
 
     UpdateDriving(deltaTime);
+
+    // computed during update rather than on draw since passengers rely on it even when car is culled
+    ComputeDrawHeight(mPhysicsComponent->mSmoothPosition);
 }
 
 void Vehicle::DrawFrame(SpriteBatch& spriteBatch)
@@ -61,7 +66,6 @@ void Vehicle::DrawFrame(SpriteBatch& spriteBatch)
     // sync sprite transformation with physical body
     cxx::angle_t rotationAngle = mPhysicsComponent->GetRotationAngle() - cxx::angle_t::from_degrees(SPRITE_ZERO_ANGLE);
     glm::vec3 position = mPhysicsComponent->mSmoothPosition;
-    ComputeDrawHeight(position);
 
     int remapClut = mRemapIndex == NO_REMAP ? 0 : (mCarStyle->mRemapsBaseIndex + mRemapIndex);
     gSpriteManager.GetSpriteTexture(mObjectID, mChassisSpriteIndex, remapClut, GetSpriteDeltas(), mChassisDrawSprite);
@@ -141,6 +145,19 @@ void Vehicle::DrawDebug(DebugRenderer& debugRender)
     }
 }
 
+void Vehicle::GetDrawBounds(cxx::aabbox_t& outBounds) const
+{
+    const SpriteStyle& spriteStyle = gGameMap.mStyleData.mSprites[mChassisSpriteIndex];
+
+    // sprite might be rotated at any angle so take half of its diagonal
+    float halfExtent = glm::length(glm::vec2(spriteStyle.mWidth, spriteStyle.mHeight)) * SPRITE_SCALE * 0.5f;
+
+    // draw height never goes below body position and never exceeds block above it
+    glm::vec3 position = mPhysicsComponent->mSmoothPosition;
+    outBounds.mMin = glm::vec3 { position.x - halfExtent, position.y, position.z - halfExtent };
+    outBounds.mMax = glm::vec3 { position.x + halfExtent, position.y + MAP_BLOCK_LENGTH, position.z + halfExtent };
+}
+
 void Vehicle::ComputeDrawHeight(const glm::vec3& position)
 {
     glm::vec2 corners[4];
@@ -496,3 +513,55 @@ void Vehicle::ReceiveDamageFromWater()
         currentPed->Die(ePedestrianDeathReason_Drowned, nullptr);
     }
 }
+
+void Vehicle::SaveSnapshot(WorldSnapshot& snapshot) const
+{
+    snapshot.Write(mDead);
+    snapshot.Write(mDrawHeight);
+    snapshot.Write(mRemapIndex);
+    snapshot.Write(mDoorsAnims);
+    snapshot.Write(mEmergLightsAnim);
+    snapshot.Write(mDamageDeltaBits);
+    snapshot.Write(mChassisSpriteIndex);
+
+    // passengers are referenced by identifiers, order is kept
+    snapshot.Write(static_cast<int>(mPassengers.size()));
+    for (const Pedestrian* currPassenger: mPassengers)
+    {
+        snapshot.Write(currPassenger->mObjectID);
+    }
+
+    mPhysicsComponent->SaveSnapshot(snapshot);
+}
+
+bool Vehicle::LoadSnapshot(WorldSnapshot& snapshot)
+{
+    int numPassengers = 0;
+    if (!snapshot.Read(mDead) || !snapshot.Read(mDrawHeight) || !snapshot.Read(mRemapIndex) ||
+        !snapshot.Read(mDoorsAnims) || !snapshot.Read(mEmergLightsAnim) || !snapshot.Read(mDamageDeltaBits) ||
+        !snapshot.Read(mChassisSpriteIndex) || !snapshot.Read(numPassengers))
+    {
+        return false;
+    }
+
+    mPassengers.clear();
+    for (int icurr = 0; icurr < numPassengers; ++icurr)
+    {
+        GameObjectID passengerID;
+        if (!snapshot.Read(passengerID))
+            return false;
+
+        Pedestrian* passenger = gGameObjectsManager.GetPedestrianByID(passengerID);
+        if (passenger == nullptr)
+            return false;
+
+        mPassengers.push_back(passenger);
+    }
+
+    if (mPhysicsComponent == nullptr)
+    {
+        mPhysicsComponent = gPhysics.CreatePhysicsComponent(this, glm::vec3(), cxx::angle_t(), mCarStyle);
+        debug_assert(mPhysicsComponent);
+    }
+    return mPhysicsComponent->LoadSnapshot(snapshot);
+}
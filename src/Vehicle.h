@@ -19,7 +19,7 @@ public:
 
     bool mDead;
 
-    float mDrawHeight;
+    float mDrawHeight; // updated every frame, valid for culled cars as well
     int mRemapIndex;
 
     CarStyle* mCarStyle; // cannot be null
@@ -85,6 +85,16 @@ public:
     
     bool IsSeatPresent(eCarSeat carSeat) const;
 
+    // get conservative bounds of car sprite in world space, used for visibility culling
+    // @param outBounds: Output bounds
+    void GetDrawBounds(cxx::aabbox_t& outBounds) const;
+
+    // write or read car state, used by world snapshots
+    // passengers must exist before load
+    // @param snapshot: Snapshot data
+    void SaveSnapshot(WorldSnapshot& snapshot) const;
+    bool LoadSnapshot(WorldSnapshot& snapshot);
+
 private:
     void UpdateDriving(Timespan deltaTime);
     void ComputeDrawHeight(const glm::vec3& position);
@@ -0,0 +1,98 @@
+#include "stdafx.h"
+#include "WorkerThreadPool.h"
+
+WorkerThreadPool::~WorkerThreadPool()
+{
+    Deinit();
+}
+
+void WorkerThreadPool::Initialize(int numThreads)
+{
+    Deinit();
+
+    mShutdown = false;
+    for (int ithread = 1; ithread < numThreads; ++ithread)
+    {
+        mWorkerThreads.emplace_back(&WorkerThreadPool::WorkerThreadProc, this);
+    }
+}
+
+void WorkerThreadPool::Deinit()
+{
+    if (mWorkerThreads.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mJobMutex);
+        mShutdown = true;
+    }
+    mJobStarted.notify_all();
+
+    for (std::thread& currThread: mWorkerThreads)
+    {
+        currThread.join();
+    }
+    mWorkerThreads.clear();
+}
+
+void WorkerThreadPool::RunChunks(int numChunks, const std::function<void(int)>& chunkFunc)
+{
+    if (numChunks < 1)
+        return;
+
+    if (numChunks == 1 || mWorkerThreads.empty())
+    {
+        for (int ichunk = 0; ichunk < numChunks; ++ichunk)
+        {
+            chunkFunc(ichunk);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mJobMutex);
+    debug_assert(mChunkFunc == nullptr);
+    mChunkFunc = &chunkFunc;
+    mChunksCount = numChunks;
+    mNextChunk = 0;
+    mPendingChunks = numChunks;
+    mJobStarted.notify_all();
+
+    ProcessChunks(lock);
+
+    // wait for chunks picked by workers
+    mJobFinished.wait(lock, [this]() { return mPendingChunks == 0; });
+    mChunkFunc = nullptr;
+    mChunksCount = 0;
+    mNextChunk = 0;
+}
+
+void WorkerThreadPool::WorkerThreadProc()
+{
+    std::unique_lock<std::mutex> lock(mJobMutex);
+    for (;;)
+    {
+        mJobStarted.wait(lock, [this]() { return mShutdown || mNextChunk < mChunksCount; });
+        if (mShutdown)
+            break;
+
+        ProcessChunks(lock);
+    }
+}
+
+void WorkerThreadPool::ProcessChunks(std::unique_lock<std::mutex>& lock)
+{
+    while (mNextChunk < mChunksCount)
+    {
+        int ichunk = mNextChunk++;
+        const std::function<void(int)>& chunkFunc = *mChunkFunc;
+
+        lock.unlock();
+        chunkFunc(ichunk);
+        lock.lock();
+
+        if (--mPendingChunks == 0)
+        {
+            mJobFinished.notify_one();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+// persistent worker threads that sleep until parallel job is dispatched,
+// avoids creating and joining threads on every frame
+class WorkerThreadPool final: public cxx::noncopyable
+{
+public:
+    ~WorkerThreadPool();
+
+    // start worker threads, caller thread takes part in jobs so pool creates one thread less
+    // @param numThreads: Number of threads including caller thread
+    void Initialize(int numThreads);
+    void Deinit();
+
+    // run job for each chunk and wait until all chunks are done, chunks are picked by caller and worker threads,
+    // must not be called concurrently from several threads
+    // @param numChunks: Number of chunks
+    // @param chunkFunc: Job function, receives chunk index
+    void RunChunks(int numChunks, const std::function<void(int)>& chunkFunc);
+
+    // get number of threads including caller thread
+    inline int GetThreadsCount() const { return static_cast<int>(mWorkerThreads.size()) + 1; }
+
+private:
+    void WorkerThreadProc();
+    // pick and run pending chunks of current job, lock must be held on call and on return
+    void ProcessChunks(std::unique_lock<std::mutex>& lock);
+
+private:
+    std::vector<std::thread> mWorkerThreads;
+    std::mutex mJobMutex;
+    std::condition_variable mJobStarted;
+    std::condition_variable mJobFinished;
+    // current job, guarded by mutex
+    const std::function<void(int)>* mChunkFunc = nullptr;
+    int mChunksCount = 0;
+    int mNextChunk = 0;
+    int mPendingChunks = 0; // chunks not yet finished
+    bool mShutdown = false;
+};
\ No newline at end of file
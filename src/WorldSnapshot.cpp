@@ -0,0 +1,146 @@
+#include "stdafx.h"
+#include "WorldSnapshot.h"
+#include "CarnageGame.h"
+
+const unsigned int WorldSnapshotMagic = 0x50534E43; // CNSP
+const unsigned int WorldSnapshotVersion = 2;
+
+// snapshot is checked against header before any of game state gets modified, 
+// so corrupted or incompatible snapshot never leaves game half restored
+struct WorldSnapshotHeader
+{
+    unsigned int mMagic;
+    unsigned int mVersion;
+    unsigned int mDataLength; // bytes following header
+    unsigned long long mDataChecksum; // fnv-1a of bytes following header
+    // settings snapshot can only be restored with
+    int mPlayersCount;
+    int mCarStylesCount;
+    bool mSingleBodyVehicles;
+};
+
+inline unsigned long long ComputeSnapshotChecksum(const unsigned char* data, size_t dataLength)
+{
+    unsigned long long checksum = 14695981039346656037ULL;
+    for (size_t icurr = 0; icurr < dataLength; ++icurr)
+    {
+        checksum ^= data[icurr];
+        checksum *= 1099511628211ULL;
+    }
+    return checksum;
+}
+
+inline void GetCurrentSnapshotSettings(WorldSnapshotHeader& header)
+{
+    header.mPlayersCount = gCarnageGame.mNumPlayers;
+    header.mCarStylesCount = static_cast<int>(gGameMap.mStyleData.mCars.size());
+    header.mSingleBodyVehicles = gSystem.mConfig.mPhysicsSingleBodyVehicles;
+}
+
+void WorldSnapshot::Capture()
+{
+    double captureStartTime = gSystem.GetSysSeconds();
+
+    WriteGameState();
+
+    mCaptureTimeMs = (gSystem.GetSysSeconds() - captureStartTime) * 1000.0;
+    gConsole.LogMessage(eLogMessage_Info, "World snapshot captured: %d bytes (%.3f ms)", (int) mData.size(), mCaptureTimeMs);
+}
+
+bool WorldSnapshot::Restore()
+{
+    if (IsNull())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot restore world snapshot, no data captured");
+        return false;
+    }
+
+    double restoreStartTime = gSystem.GetSysSeconds();
+
+    mReadCursor = 0;
+
+    WorldSnapshotHeader header;
+    if (!Read(header) || header.mMagic != WorldSnapshotMagic || header.mVersion != WorldSnapshotVersion)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot restore world snapshot, unknown data format");
+        return false;
+    }
+
+    if (header.mDataLength != mData.size() - mReadCursor || 
+        header.mDataChecksum != ComputeSnapshotChecksum(mData.data() + mReadCursor, header.mDataLength))
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot restore world snapshot, data is corrupted");
+        return false;
+    }
+
+    WorldSnapshotHeader currentSettings;
+    GetCurrentSnapshotSettings(currentSettings);
+    if (header.mPlayersCount != currentSettings.mPlayersCount || 
+        header.mCarStylesCount != currentSettings.mCarStylesCount ||
+        header.mSingleBodyVehicles != currentSettings.mSingleBodyVehicles)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot restore world snapshot, it was captured with different game settings");
+        return false;
+    }
+
+    // current world gets destroyed during load, keep it to get back to if load fails half way
+    WorldSnapshot backupSnapshot;
+    backupSnapshot.WriteGameState();
+
+    // data is intact at this point, failed load means snapshot writer and reader are out of sync
+    if (!gCarnageGame.LoadSnapshot(*this))
+    {
+        gConsole.LogMessage(eLogMessage_Error, "Cannot restore world snapshot, data is corrupted");
+
+        backupSnapshot.mReadCursor = sizeof(WorldSnapshotHeader);
+        if (!gCarnageGame.LoadSnapshot(backupSnapshot))
+        {
+            debug_assert(false);
+        }
+        return false;
+    }
+    debug_assert(mReadCursor == mData.size());
+
+    mRestoreTimeMs = (gSystem.GetSysSeconds() - restoreStartTime) * 1000.0;
+    gConsole.LogMessage(eLogMessage_Info, "World snapshot restored (%.3f ms)", mRestoreTimeMs);
+    return true;
+}
+
+void WorldSnapshot::WriteGameState()
+{
+    Clear();
+
+    WorldSnapshotHeader header {};
+    Write(header); // reserve space, filled after game state is written
+    gCarnageGame.SaveSnapshot(*this);
+
+    header.mMagic = WorldSnapshotMagic;
+    header.mVersion = WorldSnapshotVersion;
+    header.mDataLength = static_cast<unsigned int>(mData.size() - sizeof(header));
+    header.mDataChecksum = ComputeSnapshotChecksum(mData.data() + sizeof(header), header.mDataLength);
+    GetCurrentSnapshotSettings(header);
+    memcpy(mData.data(), &header, sizeof(header));
+}
+
+void WorldSnapshot::Clear()
+{
+    mData.clear();
+    mReadCursor = 0;
+}
+
+void WorldSnapshot::WriteString(const std::string& value)
+{
+    Write(static_cast<unsigned int>(value.length()));
+    mData.insert(mData.end(), value.begin(), value.end());
+}
+
+bool WorldSnapshot::ReadString(std::string& value)
+{
+    unsigned int stringLength = 0;
+    if (!Read(stringLength) || mReadCursor + stringLength > mData.size())
+        return false;
+
+    value.assign(reinterpret_cast<const char*>(mData.data()) + mReadCursor, stringLength);
+    mReadCursor += stringLength;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+// binary snapshot of whole simulation state, used to reset game to known scene quickly 
+// without reloading map and respawning objects
+class WorldSnapshot final: public cxx::noncopyable
+{
+public:
+    // public for convenience, should not be modified directly
+    double mCaptureTimeMs = 0.0; // time spent in last capture
+    double mRestoreTimeMs = 0.0; // time spent in last restore
+
+public:
+    // capture current simulation state, previous snapshot data is discarded
+    void Capture();
+
+    // replace current simulation state with snapshot, all game objects and physics world are recreated,
+    // don't call this method while game objects update
+    // snapshot gets validated by header checksum and settings first, game state is not touched when it is rejected,
+    // previous game state is brought back if load fails half way
+    // @returns false on error
+    bool Restore();
+
+    void Clear();
+    inline bool IsNull() const { return mData.empty(); }
+
+    // write or read plain data value, values must be read in same order as they were written
+    // @param value: Value
+    template<typename TValue>
+    inline void Write(const TValue& value)
+    {
+        static_assert(std::is_trivially_copyable<TValue>::value, "Only plain data types are allowed");
+        const unsigned char* valueBytes = reinterpret_cast<const unsigned char*>(&value);
+        mData.insert(mData.end(), valueBytes, valueBytes + sizeof(TValue));
+    }
+
+    template<typename TValue>
+    inline bool Read(TValue& value)
+    {
+        static_assert(std::is_trivially_copyable<TValue>::value, "Only plain data types are allowed");
+        if (mReadCursor + sizeof(TValue) > mData.size())
+            return false;
+
+        memcpy(&value, mData.data() + mReadCursor, sizeof(TValue));
+        mReadCursor += sizeof(TValue);
+        return true;
+    }
+
+    // write or read string
+    // @param value: String value
+    void WriteString(const std::string& value);
+    bool ReadString(std::string& value);
+
+private:
+    // write header and current game state, previous snapshot data is discarded
+    void WriteGameState();
+
+private:
+    std::vector<unsigned char> mData;
+    size_t mReadCursor = 0;
+};
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "stdafx.h"
+#include "WorldStateHash.h"
+#include "CarnageGame.h"
+#include "PhysicsComponents.h"
+#include "PhysicsManager.h"
+
+const unsigned int WorldStateHashLogMagic = 0x4C48534E; // NSHL
+const unsigned int WorldStateHashLogVersion = 2;
+
+//////////////////////////////////////////////////////////////////////////
+
+// fnv-1a over raw bytes, floats are hashed bitwise so any difference in last bit is detected
+struct StateHasher
+{
+public:
+    template<typename TValue>
+    inline void Add(const TValue& value)
+    {
+        static_assert(std::is_trivially_copyable<TValue>::value, "Only plain data types are allowed");
+        AddBytes(&value, sizeof(TValue));
+    }
+
+    inline void AddBytes(const void* data, size_t dataLength)
+    {
+        const unsigned char* dataBytes = static_cast<const unsigned char*>(data);
+        for (size_t icurr = 0; icurr < dataLength; ++icurr)
+        {
+            mValue ^= dataBytes[icurr];
+            mValue *= 1099511628211ULL;
+        }
+    }
+
+public:
+    unsigned long long mValue = 14695981039346656037ULL;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+WorldStateHashLog gWorldStateHashLog;
+
+bool WorldStateHashLog::Initialize(const char* logFileName)
+{
+    Deinit();
+
+    mLogFile.open(logFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!mLogFile.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot create world state hash log '%s'", logFileName);
+        return false;
+    }
+
+    mLogFile.write(reinterpret_cast<const char*>(&WorldStateHashLogMagic), sizeof(WorldStateHashLogMagic));
+    mLogFile.write(reinterpret_cast<const char*>(&WorldStateHashLogVersion), sizeof(WorldStateHashLogVersion));
+
+    gConsole.LogMessage(eLogMessage_Info, "World state hash log started '%s'", logFileName);
+    return true;
+}
+
+void WorldStateHashLog::Deinit()
+{
+    if (mLogFile.is_open())
+    {
+        mLogFile.close();
+        gConsole.LogMessage(eLogMessage_Info, "World state hash log finished: %d ticks, last hash %016llx", mTicksCount, mLastTickHash);
+    }
+    mCurrentTick.mObjects.clear();
+    mLastTickHash = 0;
+    mTicksCount = 0;
+}
+
+bool WorldStateHashLog::IsLogActive() const
+{
+    return mLogFile.is_open();
+}
+
+void WorldStateHashLog::ProcessTick()
+{
+    if (!IsLogActive())
+        return;
+
+    mCurrentTick.mTickIndex = mTicksCount;
+    mCurrentTick.mGameTimeMs = gCarnageGame.mGameTime.mMilliseconds;
+    mCurrentTick.mObjects.clear();
+
+    StateHasher globalHasher;
+    globalHasher.Add(mCurrentTick.mGameTimeMs);
+    gCarnageGame.mGameRand.get_state(mRandomState);
+    globalHasher.AddBytes(mRandomState.data(), mRandomState.length());
+    globalHasher.Add(gPhysics.GetSimulationTimeAccumulator());
+    mCurrentTick.mGlobalHash = globalHasher.mValue;
+
+    StateHasher tickHasher;
+    tickHasher.Add(mCurrentTick.mGlobalHash);
+
+    // objects list keeps creation order, which is same between identical runs
+    for (const GameObject* currObject: gGameObjectsManager.mObjectsList)
+    {
+        if (gGameObjectsManager.IsMarkedForDeletion(currObject))
+            continue;
+
+        StateHasher objectHasher;
+        objectHasher.Add(currObject->mObjectID);
+        objectHasher.Add(currObject->mObjectTypeID);
+
+        const PhysicsComponent* physicsComponent = nullptr;
+        if (currObject->mObjectTypeID == eGameObjectType_Pedestrian)
+        {
+            const Pedestrian* pedestrian = static_cast<const Pedestrian*>(currObject);
+            physicsComponent = pedestrian->mPhysicsComponent;
+            objectHasher.Add(pedestrian->GetCurrentStateID());
+            objectHasher.Add(pedestrian->mCurrentStateTime.mMilliseconds);
+            objectHasher.Add(pedestrian->mCurrentWeapon);
+            objectHasher.Add(pedestrian->mWeaponsAmmo);
+            objectHasher.Add(pedestrian->mCurrentCar ? pedestrian->mCurrentCar->mObjectID : GAMEOBJECT_ID_NULL);
+        }
+        else if (currObject->mObjectTypeID == eGameObjectType_Car)
+        {
+            const Vehicle* car = static_cast<const Vehicle*>(currObject);
+            physicsComponent = car->mPhysicsComponent;
+            objectHasher.Add(car->mDead);
+        }
+
+        if (physicsComponent)
+        {
+            objectHasher.Add(physicsComponent->GetPosition());
+            objectHasher.Add(physicsComponent->GetRotationAngle().to_degrees());
+            objectHasher.Add(physicsComponent->GetLinearVelocity());
+            objectHasher.Add(physicsComponent->GetAngularVelocity());
+        }
+
+        ObjectHash objectHash;
+        objectHash.mObjectID = currObject->mObjectID;
+        objectHash.mObjectType = currObject->mObjectTypeID;
+        objectHash.mHash = objectHasher.mValue;
+        mCurrentTick.mObjects.push_back(objectHash);
+
+        tickHasher.Add(objectHash.mHash);
+    }
+    mCurrentTick.mTickHash = tickHasher.mValue;
+
+    // write record fields one by one, so file does not contain struct padding
+    int numObjects = static_cast<int>(mCurrentTick.mObjects.size());
+    mLogFile.write(reinterpret_cast<const char*>(&mCurrentTick.mTickIndex), sizeof(mCurrentTick.mTickIndex));
+    mLogFile.write(reinterpret_cast<const char*>(&mCurrentTick.mGameTimeMs), sizeof(mCurrentTick.mGameTimeMs));
+    mLogFile.write(reinterpret_cast<const char*>(&mCurrentTick.mTickHash), sizeof(mCurrentTick.mTickHash));
+    mLogFile.write(reinterpret_cast<const char*>(&mCurrentTick.mGlobalHash), sizeof(mCurrentTick.mGlobalHash));
+    mLogFile.write(reinterpret_cast<const char*>(&numObjects), sizeof(numObjects));
+    for (const ObjectHash& currObject: mCurrentTick.mObjects)
+    {
+        unsigned char objectType = static_cast<unsigned char>(currObject.mObjectType);
+        mLogFile.write(reinterpret_cast<const char*>(&currObject.mObjectID), sizeof(currObject.mObjectID));
+        mLogFile.write(reinterpret_cast<const char*>(&objectType), sizeof(objectType));
+        mLogFile.write(reinterpret_cast<const char*>(&currObject.mHash), sizeof(currObject.mHash));
+    }
+
+    mLastTickHash = mCurrentTick.mTickHash;
+    ++mTicksCount;
+}
+
+bool WorldStateHashLog::ReadLogHeader(std::ifstream& fileStream, const char* fileName)
+{
+    if (!fileStream.is_open())
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Cannot open world state hash log '%s'", fileName);
+        return false;
+    }
+
+    unsigned int magic = 0;
+    unsigned int version = 0;
+    fileStream.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    fileStream.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!fileStream || magic != WorldStateHashLogMagic || version != WorldStateHashLogVersion)
+    {
+        gConsole.LogMessage(eLogMessage_Warning, "Unknown world state hash log format '%s'", fileName);
+        return false;
+    }
+    return true;
+}
+
+bool WorldStateHashLog::ReadTickRecord(std::ifstream& fileStream, TickRecord& record)
+{
+    int numObjects = 0;
+    fileStream.read(reinterpret_cast<char*>(&record.mTickIndex), sizeof(record.mTickIndex));
+    fileStream.read(reinterpret_cast<char*>(&record.mGameTimeMs), sizeof(record.mGameTimeMs));
+    fileStream.read(reinterpret_cast<char*>(&record.mTickHash), sizeof(record.mTickHash));
+    fileStream.read(reinterpret_cast<char*>(&record.mGlobalHash), sizeof(record.mGlobalHash));
+    fileStream.read(reinterpret_cast<char*>(&numObjects), sizeof(numObjects));
+    // objects count is limited by handle slots, anything above means log is corrupted
+    if (!fileStream || numObjects < 0 || numObjects > static_cast<int>(GameObjectHandle::MaxSlots))
+        return false;
+
+    record.mObjects.resize(numObjects);
+    for (ObjectHash& currObject: record.mObjects)
+    {
+        unsigned char objectType = 0;
+        fileStream.read(reinterpret_cast<char*>(&currObject.mObjectID), sizeof(currObject.mObjectID));
+        fileStream.read(reinterpret_cast<char*>(&objectType), sizeof(objectType));
+        fileStream.read(reinterpret_cast<char*>(&currObject.mHash), sizeof(currObject.mHash));
+        currObject.mObjectType = static_cast<eGameObjectType>(objectType);
+    }
+    return !fileStream.fail();
+}
+
+bool WorldStateHashLog::CompareLogFiles(const char* fileNameA, const char* fileNameB)
+{
+    std::ifstream fileStreamA {fileNameA, std::ios::in | std::ios::binary};
+    std::ifstream fileStreamB {fileNameB, std::ios::in | std::ios::binary};
+    if (!ReadLogHeader(fileStreamA, fileNameA) || !ReadLogHeader(fileStreamB, fileNameB))
+        return false;
+
+    TickRecord recordA;
+    TickRecord recordB;
+    for (int numTicks = 0; ; ++numTicks)
+    {
+        bool hasRecordA = ReadTickRecord(fileStreamA, recordA);
+        bool hasRecordB = ReadTickRecord(fileStreamB, recordB);
+        if (!hasRecordA || !hasRecordB)
+        {
+            if (hasRecordA != hasRecordB)
+            {
+                gConsole.LogMessage(eLogMessage_Warning, "World state hash logs have different length, identical for first %d ticks", numTicks);
+                return false;
+            }
+            gConsole.LogMessage(eLogMessage_Info, "World state hash logs are identical, %d ticks", numTicks);
+            return true;
+        }
+
+        if (recordA.mTickHash == recordB.mTickHash)
+            continue;
+
+        gConsole.LogMessage(eLogMessage_Warning, "World state diverges at tick %d (game time %lld ms / %lld ms)", 
+            recordA.mTickIndex, recordA.mGameTimeMs, recordB.mGameTimeMs);
+
+        if (recordA.mGlobalHash != recordB.mGlobalHash)
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Global state differs: game time, random generator or physics accumulator");
+        }
+
+        // find first object which differs, objects are stored in creation order
+        size_t numObjects = std::min(recordA.mObjects.size(), recordB.mObjects.size());
+        for (size_t iobject = 0; iobject < numObjects; ++iobject)
+        {
+            const ObjectHash& objectA = recordA.mObjects[iobject];
+            const ObjectHash& objectB = recordB.mObjects[iobject];
+            if (objectA.mObjectID != objectB.mObjectID || objectA.mObjectType != objectB.mObjectType)
+            {
+                gConsole.LogMessage(eLogMessage_Warning, "Objects differ: %s %u / %s %u", 
+                    cxx::enum_to_string(objectA.mObjectType), objectA.mObjectID, 
+                    cxx::enum_to_string(objectB.mObjectType), objectB.mObjectID);
+                return false;
+            }
+            if (objectA.mHash != objectB.mHash)
+            {
+                gConsole.LogMessage(eLogMessage_Warning, "Object state differs: %s %u", cxx::enum_to_string(objectA.mObjectType), objectA.mObjectID);
+                return false;
+            }
+        }
+
+        if (recordA.mObjects.size() != recordB.mObjects.size())
+        {
+            gConsole.LogMessage(eLogMessage_Warning, "Objects count differs: %d / %d", 
+                (int) recordA.mObjects.size(), (int) recordB.mObjects.size());
+        }
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+// computes hashes of simulation state every game tick and writes them to compact binary log,
+// logs of two runs with same startup parameters are compared to find first tick and object where simulation diverges,
+// intended to verify that optimizations of physics and gameobjects update do not change behaviour
+class WorldStateHashLog final: public cxx::noncopyable
+{
+public:
+    // public for convenience, should not be modified directly
+    Timespan mFrameDelta {16}; // fixed game update time step while logging
+    unsigned long long mLastTickHash = 0;
+    int mTicksCount = 0;
+
+public:
+    // Create log file and start logging
+    // @param logFileName: Output file name
+    bool Initialize(const char* logFileName);
+    void Deinit();
+
+    // Compute hashes of current simulation state and append them to log, should be called after game update
+    void ProcessTick();
+
+    // Test whether logging is running and game update should use fixed time step
+    bool IsLogActive() const;
+
+    // Compare two logs and report first diverged tick and object
+    // @param fileNameA, fileNameB: Log files
+    // @returns false if logs are different or cannot be read
+    static bool CompareLogFiles(const char* fileNameA, const char* fileNameB);
+
+private:
+    // hash of single gameobject at current tick
+    struct ObjectHash
+    {
+    public:
+        GameObjectID mObjectID;
+        eGameObjectType mObjectType;
+        unsigned long long mHash;
+    };
+
+    // all hashes of single tick as they are stored in log
+    struct TickRecord
+    {
+    public:
+        int mTickIndex = 0;
+        long long mGameTimeMs = 0;
+        unsigned long long mTickHash = 0; // combined hash of all objects and global state
+        unsigned long long mGlobalHash = 0; // game time, random generator and physics accumulator
+        std::vector<ObjectHash> mObjects;
+    };
+
+    static bool ReadTickRecord(std::ifstream& fileStream, TickRecord& record);
+    static bool ReadLogHeader(std::ifstream& fileStream, const char* fileName);
+
+private:
+    std::ofstream mLogFile;
+    TickRecord mCurrentTick;
+    std::string mRandomState;
+};
+
+extern WorldStateHashLog gWorldStateHashLog;
\ No newline at end of file
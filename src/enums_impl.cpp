@@ -3,6 +3,8 @@
 #include "GameDefs.h"
 #include "GraphicsDefs.h"
 #include "GameObject.h"
+#include "RenderingManager.h"
+#include "PhysicsDefs.h"
 
 impl_enum_strings(eKeycode)
 {
@@ -551,4 +553,44 @@ impl_enum_strings(ePedestrianDeathReason)
     {ePedestrianDeathReason_Electrocuted, "Electrocuted"},
     {ePedestrianDeathReason_Drowned, "Drowned"},
     {ePedestrianDeathReason_HitByCar, "HitByCar"},
+};
+
+impl_enum_strings(eRenderStatsCounter)
+{
+    {eRenderStatsCounter_DrawCalls, "DrawCalls"},
+    {eRenderStatsCounter_Primitives, "Primitives"},
+    {eRenderStatsCounter_TextureBinds, "TextureBinds"},
+    {eRenderStatsCounter_BufferBytesUploaded, "BufferBytesUploaded"},
+    {eRenderStatsCounter_TextureBytesUploaded, "TextureBytesUploaded"},
+    {eRenderStatsCounter_SpritesCacheMisses, "SpritesCacheMisses"},
+};
+
+impl_enum_strings(eRenderStage)
+{
+    {eRenderStage_Prepare, "Prepare"},
+    {eRenderStage_Extraction, "Extraction"},
+    {eRenderStage_Recording, "Recording"},
+    {eRenderStage_Submission, "Submission"},
+    {eRenderStage_UI, "UI"},
+    {eRenderStage_Present, "Present"},
+};
+
+impl_enum_strings(ePhysicsStatsCounter)
+{
+    {ePhysicsStatsCounter_BroadphasePairs, "BroadphasePairs"},
+    {ePhysicsStatsCounter_TouchingContacts, "TouchingContacts"},
+    {ePhysicsStatsCounter_PreSolvePedVsMap, "PreSolvePedVsMap"},
+    {ePhysicsStatsCounter_PreSolveCarVsMap, "PreSolveCarVsMap"},
+    {ePhysicsStatsCounter_PreSolvePedVsCar, "PreSolvePedVsCar"},
+    {ePhysicsStatsCounter_PreSolvePedVsPed, "PreSolvePedVsPed"},
+    {ePhysicsStatsCounter_PreSolveOther, "PreSolveOther"},
+    {ePhysicsStatsCounter_SensorEvents, "SensorEvents"},
+};
+
+impl_enum_strings(ePhysicsStage)
+{
+    {ePhysicsStage_WorldStep, "WorldStep"},
+    {ePhysicsStage_KinematicPeds, "KinematicPeds"},
+    {ePhysicsStage_ComponentsStep, "ComponentsStep"},
+    {ePhysicsStage_Gravity, "Gravity"},
 };
\ No newline at end of file
@@ -14,6 +14,14 @@ namespace cxx
         NUM_FRUSTUM_PLANES
     };
 
+    // frustum vs bounding volume classification result
+    enum
+    {
+        FRUSTUM_OUTSIDE,
+        FRUSTUM_INTERSECTS,
+        FRUSTUM_INSIDE,
+    };
+
     // defines camera frustum
     struct frustum_t
     {
@@ -104,6 +112,39 @@ namespace cxx
             return true;
         }
 
+        // classify bounding box against frustum, unlike 'contains' also detects whether box is entirely inside
+        // @param boundingBox: AABBox data
+        // @returns FRUSTUM_OUTSIDE, FRUSTUM_INTERSECTS or FRUSTUM_INSIDE
+        int classify(const aabbox_t& boundingBox) const
+        {
+            int result = FRUSTUM_INSIDE;
+            for (int iplane = 0; iplane < NUM_FRUSTUM_PLANES; ++iplane)
+            {
+                const plane3d_t& plane = mPlanes[iplane];
+                // box corners that are farthest and nearest along plane normal
+                const glm::vec3 farthestCorner
+                {
+                    (plane.mNormal.x >= 0.0f) ? boundingBox.mMax.x : boundingBox.mMin.x,
+                    (plane.mNormal.y >= 0.0f) ? boundingBox.mMax.y : boundingBox.mMin.y,
+                    (plane.mNormal.z >= 0.0f) ? boundingBox.mMax.z : boundingBox.mMin.z
+                };
+                if (plane.get_distance_from_point(farthestCorner) <= 0.0f)
+                    return FRUSTUM_OUTSIDE;
+
+                const glm::vec3 nearestCorner
+                {
+                    (plane.mNormal.x >= 0.0f) ? boundingBox.mMin.x : boundingBox.mMax.x,
+                    (plane.mNormal.y >= 0.0f) ? boundingBox.mMin.y : boundingBox.mMax.y,
+                    (plane.mNormal.z >= 0.0f) ? boundingBox.mMin.z : boundingBox.mMax.z
+                };
+                if (plane.get_distance_from_point(nearestCorner) <= 0.0f)
+                {
+                    result = FRUSTUM_INTERSECTS;
+                }
+            }
+            return result;
+        }
+
         // test point in frustum
         // @param pointPosition: Point position
         inline bool contains(const glm::vec3& pointPosition) const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <random>
+#include <sstream>
 
 namespace cxx
 {
@@ -49,6 +50,21 @@ namespace cxx
             return generate_int() / (mDistribution.max() * 1.0f + 1.0f);
         }
 
+        // save or restore generator state, state is stored in portable text form
+        // @param state: State string
+        inline void get_state(std::string& state) const
+        {
+            std::ostringstream outputStream;
+            outputStream << mRandomGeneratorEngine << ' ' << mDistribution;
+            state = outputStream.str();
+        }
+
+        inline void set_state(const std::string& state)
+        {
+            std::istringstream inputStream(state);
+            inputStream >> mRandomGeneratorEngine >> mDistribution;
+        }
+
     private:
         std::mt19937 mRandomGeneratorEngine;
         std::uniform_int_distribution<> mDistribution;
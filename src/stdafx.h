@@ -63,6 +63,8 @@ inline void SafeDeleteArray(TElement*& elementPointer)
 #include <cctype>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <functional>
 
 // opengl
@@ -89,7 +91,6 @@ inline void SafeDeleteArray(TElement*& elementPointer)
 #include "aux_math.h"
 #include "geometries.h"
 #include "frustum.h"
-#include "handle.h"
 #include "intrusive_list.h"
 #include "memory_istream.h"
 #include "noncopyable.h"